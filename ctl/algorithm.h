@@ -75,6 +75,15 @@ static inline bool JOIN(A, none_of)(A *self, int _match(T *))
 static inline bool JOIN(A, find_range)(I *range, T value)
 {
     A *self = range->container;
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    if (!JOIN(I, done)(range) && JOIN(A, _simd)(self))
+    {
+        const size_t n = range->end - range->ref;
+        const size_t i = JOIN(A, _simd_find)(range->ref, n, value, true);
+        range->ref += i;
+        return i < n;
+    }
+#endif
     foreach_range_(A, i, range)
     {
         if (JOIN(A, _equal)(self, i.ref, &value))
@@ -188,7 +197,7 @@ static inline A *JOIN(A, copy_range)(GI *range, A *out)
 static inline int JOIN(A, _found)(A *a, T *ref)
 {
 #ifdef CTL_STR
-    return strchr(a->vector, *ref) ? 1 : 0;
+    return strchr(JOIN(A, data)(a), *ref) ? 1 : 0;
 #else
     JOIN(A, it) iter = JOIN(A, find)(a, *ref);
     return !JOIN(I, done)(&iter);
@@ -208,7 +217,7 @@ JOIN(A, union)(A* a, A* b)
     {
         if (JOIN(I, done)(&it2))
             return *JOIN(A, copy_range)(&it1, &self);
-        if (self.compare(it2.ref, it1.ref))
+        if (_CTL_COMPARE(self.compare, it2.ref, it1.ref))
         {
             JOIN(A, inserter)(&self, self.copy(it2.ref));
             JOIN(I, next)(&it2);
@@ -216,7 +225,7 @@ JOIN(A, union)(A* a, A* b)
         else
         {
             JOIN(A, inserter)(&self, self.copy(it1.ref));
-            if (!self.compare(it1.ref, it2.ref))
+            if (!_CTL_COMPARE(self.compare, it1.ref, it2.ref))
                 JOIN(I, next)(&it2);
             JOIN(I, next)(&it1);
         }
@@ -236,7 +245,7 @@ static inline A JOIN(A, union_range)(I *r1, GI *r2)
     {
         if (done2(r2))
             return *JOIN(A, copy_range)(r1, &self);
-        if (self.compare(ref2(r2), r1->ref))
+        if (_CTL_COMPARE(self.compare, ref2(r2), r1->ref))
         {
             JOIN(A, inserter)(&self, self.copy(ref2(r2)));
             next2(r2);
@@ -244,7 +253,7 @@ static inline A JOIN(A, union_range)(I *r1, GI *r2)
         else
         {
             JOIN(A, inserter)(&self, self.copy(r1->ref));
-            if (!self.compare(r1->ref, ref2(r2)))
+            if (!_CTL_COMPARE(self.compare, r1->ref, ref2(r2)))
                 next2(r2);
             JOIN(I, next)(r1);
         }
@@ -273,11 +282,11 @@ static inline A JOIN(A, intersection_range)(I *r1, GI *r2)
 
     while (!JOIN(I, done)(r1) && !done2(r2))
     {
-        if (self.compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self.compare, r1->ref, ref2(r2)))
             JOIN(I, next)(r1);
         else
         {
-            if (!self.compare(ref2(r2), r1->ref))
+            if (!_CTL_COMPARE(self.compare, ref2(r2), r1->ref))
             {
                 JOIN(A, inserter)(&self, self.copy(r1->ref));
                 JOIN(I, next)(r1);
@@ -324,14 +333,14 @@ static inline A JOIN(A, difference_range)(I *r1, GI *r2)
         if (done2(r2))
             return *JOIN(A, copy_range)(r1, &self);
         // r1 < r2 (fails with 3-way compare)
-        if (self.compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self.compare, r1->ref, ref2(r2)))
         {
             JOIN(A, inserter)(&self, self.copy(r1->ref));
             JOIN(I, next)(r1);
         }
         else
         {
-            if (!self.compare(ref2(r2), r1->ref))
+            if (!_CTL_COMPARE(self.compare, ref2(r2), r1->ref))
                 JOIN(I, next)(r1);
             next2(r2);
         }
@@ -351,14 +360,14 @@ static inline A JOIN(A, symmetric_difference_range)(I *r1, GI *r2)
         if (done2(r2))
             return *JOIN(A, copy_range)(r1, &self);
 
-        if (self.compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self.compare, r1->ref, ref2(r2)))
         {
             JOIN(A, inserter)(&self, self.copy(r1->ref));
             JOIN(I, next)(r1);
         }
         else
         {
-            if (self.compare(ref2(r2), r1->ref))
+            if (_CTL_COMPARE(self.compare, ref2(r2), r1->ref))
                 JOIN(A, inserter)(&self, self.copy(ref2(r2)));
             else
                 JOIN(I, next)(r1);
@@ -418,9 +427,9 @@ static inline bool JOIN(A, includes_range)(I *r1, GI *r2)
 
     while (!done2(r2))
     {
-        if (JOIN(I, done)(r1) || self->compare(ref2(r2), r1->ref))
+        if (JOIN(I, done)(r1) || _CTL_COMPARE(self->compare, ref2(r2), r1->ref))
             return false;
-        if (!self->compare(r1->ref, ref2(r2)))
+        if (!_CTL_COMPARE(self->compare, r1->ref, ref2(r2)))
             next2(r2);
         JOIN(I, next)(r1);
     }
@@ -473,7 +482,7 @@ static inline I* JOIN(A, is_sorted_until)(I *first, I *last)
         I next = *first;
         JOIN(I, next)(&next);
         while (!JOIN(I, done)(&next)) {
-            if (self->compare(next.ref, first->ref))
+            if (_CTL_COMPARE(self->compare, next.ref, first->ref))
             {
                 *first = next;
                 return first;
@@ -674,7 +683,7 @@ static inline A JOIN(A, merge_range)(I *r1, GI *r2)
     {
         if (done2(r2))
             return *JOIN(A, copy_range)(r1, &self);
-        if (self.compare(ref2(r2), r1->ref))
+        if (_CTL_COMPARE(self.compare, ref2(r2), r1->ref))
         {
             JOIN(A, inserter)(&self, self.copy(ref2(r2)));
             next2(r2);
@@ -752,6 +761,10 @@ static inline size_t JOIN(A, count_range)(I *range, T value)
 {
     A *self = range->container;
     size_t count = 0;
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    if (!JOIN(I, done)(range) && JOIN(A, _simd)(self))
+        return JOIN(A, _simd_count)(range->ref, range->end - range->ref, value);
+#endif
     foreach_range_(A, i, range) if (JOIN(A, _equal)(self, i.ref, &value)) count++;
     if (self->free)
         self->free(&value);
@@ -762,6 +775,13 @@ static inline size_t JOIN(A, count_range)(I *range, T value)
 static inline size_t JOIN(A, count)(A *self, T value)
 {
     size_t count = 0;
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    if (JOIN(A, _simd)(self))
+    {
+        I range = JOIN(A, begin)(self);
+        return JOIN(A, _simd_count)(range.ref, range.end - range.ref, value);
+    }
+#endif
     foreach (A, self, i)
         if (JOIN(A, _equal)(self, i.ref, &value))
             count++;
@@ -780,6 +800,19 @@ static inline bool JOIN(A, mismatch)(I *range1, GI *range2)
     int (*done2)(struct I*) = range2->vtable.done;
 
     int done1 = JOIN(I, done)(range1);
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    // the same contiguous iterators
+    if (!done1 && !done2(range2) && next2 == JOIN(I, next) && JOIN(A, _simd)(self))
+    {
+        const size_t n1 = range1->end - range1->ref;
+        const size_t n2 = range2->end - range2->ref;
+        const size_t n = n1 < n2 ? n1 : n2;
+        const size_t i = JOIN(A, _simd_mismatch)(range1->ref, range2->ref, n);
+        range1->ref += i;
+        range2->ref += i;
+        return i < n;
+    }
+#endif
     if (!done2(range2))
         while (!done1 && JOIN(A, _equal)(self, range1->ref, ref2(range2)))
         {
@@ -804,8 +837,8 @@ static inline bool JOIN(A, lexicographical_compare)(I *range1, GI *range2)
     int (*done2)(struct I*) = range2->vtable.done;
 
     for ( ; !JOIN(I, done)(range1) && !done2(range2); JOIN(I, next)(range1), next2(range2)) {
-        if (self->compare(range1->ref, ref2(range2))) return true;
-        if (self->compare(ref2(range2), range1->ref)) return false;
+        if (_CTL_COMPARE(self->compare, range1->ref, ref2(range2))) return true;
+        if (_CTL_COMPARE(self->compare, ref2(range2), range1->ref)) return false;
     }
     return JOIN(I, done)(range1) && !done2(range2);
 }
@@ -1080,6 +1113,13 @@ static inline bool JOIN(A, equal_value)(I *range, T value)
 {
     bool result = !JOIN(I, done)(range);
     A *self = range->container;
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    if (result && JOIN(A, _simd)(self))
+    {
+        const size_t n = range->end - range->ref;
+        return JOIN(A, _simd_find)(range->ref, n, value, false) == n;
+    }
+#endif
     foreach_range_(A, i, range)
     {
         if (!JOIN(A, _equal)(self, i.ref, &value))
@@ -1107,6 +1147,19 @@ static inline bool JOIN(A, equal_range)(I *range1, GI *range2)
     T* (*ref2)(struct I*) = range2->vtable.ref;
     int (*done2)(struct I*) = range2->vtable.done;
 
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    // the same contiguous iterators
+    if (next2 == JOIN(I, next) && JOIN(A, _simd)(self))
+    {
+        const size_t n1 = range1->end - range1->ref;
+        const size_t n2 = range2->end - range2->ref;
+        const size_t n = n1 < n2 ? n1 : n2;
+        const size_t i = JOIN(A, _simd_mismatch)(range1->ref, range2->ref, n);
+        range1->ref += i;
+        range2->ref += i;
+        return i == n && n1 == n2;
+    }
+#endif
     while (!JOIN(I, done)(range1))
     {
         if (done2(range2) || !JOIN(A, _equal)(self, range1->ref, ref2(range2)))
@@ -1136,7 +1189,7 @@ static inline I *JOIN(A, lower_bound_range)(I *range, T value)
         it = *range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (self->compare(it.ref, &value))
+        if (_CTL_COMPARE(self->compare, it.ref, &value))
         {
             JOIN(I, next)(&it);
             *range = it;
@@ -1162,7 +1215,7 @@ static inline I *JOIN(A, upper_bound_range)(I *range, T value)
         it = *range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (!self->compare(&value, it.ref))
+        if (!_CTL_COMPARE(self->compare, &value, it.ref))
         {
             JOIN(I, next)(&it);
             *range = it;
@@ -1188,7 +1241,7 @@ static inline I JOIN(A, lower_bound)(A *self, T value)
         it = range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (self->compare(it.ref, &value))
+        if (_CTL_COMPARE(self->compare, it.ref, &value))
         {
             JOIN(I, next)(&it);
             range = it;
@@ -1214,7 +1267,7 @@ static inline I JOIN(A, upper_bound)(A *self, T value)
         it = range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (!self->compare(&value, it.ref))
+        if (!_CTL_COMPARE(self->compare, &value, it.ref))
         {
             JOIN(I, next)(&it);
             range = it;
@@ -1247,7 +1300,7 @@ static inline bool JOIN(A, binary_search_range)(I *range, T value)
         it = *range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (self->compare(it.ref, &value))
+        if (_CTL_COMPARE(self->compare, it.ref, &value))
         {
             JOIN(I, next)(&it);
             *range = it;
@@ -1256,7 +1309,7 @@ static inline bool JOIN(A, binary_search_range)(I *range, T value)
         else
             count = step;
     }
-    result = !JOIN(I, done)(range) && !self->compare(&value, range->ref);
+    result = !JOIN(I, done)(range) && !_CTL_COMPARE(self->compare, &value, range->ref);
     if (self->free)
         self->free(&value);
     return result;
@@ -1281,7 +1334,7 @@ static inline bool JOIN(A, binary_search)(A *self, T value)
         it = range;
         JOIN(I, advance)(&it, (long)step);
         // requires 2way compare
-        if (self->compare(it.ref, &value))
+        if (_CTL_COMPARE(self->compare, it.ref, &value))
         {
             JOIN(I, next)(&it);
             range = it;
@@ -1290,7 +1343,7 @@ static inline bool JOIN(A, binary_search)(A *self, T value)
         else
             count = step;
     }
-    result = !JOIN(I, done)(&range) && !self->compare(&value, range.ref);
+    result = !JOIN(I, done)(&range) && !_CTL_COMPARE(self->compare, &value, range.ref);
     if (self->free)
         self->free(&value);
     return result;
@@ -243,11 +243,22 @@ static inline void JOIN(A, set)(A *self, size_t index, T value)
     *ref = value;
 }
 
+#ifndef _CTL_BYTE
+#define _CTL_BYTE
+// the byte of a 1-byte T for memset, compiled also for pointers
+static inline int _ctl_byte(const void *value)
+{
+    unsigned char c;
+    memcpy(&c, value, 1);
+    return c;
+}
+#endif
+
 static inline void JOIN(A, fill)(A *self, T value)
 {
 #if defined(POD) && !defined(NOT_INTEGRAL)
     if (sizeof(T) <= sizeof(char)) // only for bytes
-        memset(self->vector, value, N * sizeof(T));
+        memset(self->vector, _ctl_byte(&value), N * sizeof(T));
     else
         for (size_t i = 0; i < N; i++)
             self->vector[i] = value;
@@ -266,7 +277,7 @@ static inline void JOIN(A, fill_range)(I *range, T value)
     size_t n = JOIN(I, distance_range)(range);
 #if defined(POD) && !defined(NOT_INTEGRAL)
     if (sizeof(T) <= sizeof(char)) // only for bytes
-        memset(range->ref, value, n * sizeof(T));
+        memset(range->ref, _ctl_byte(&value), n * sizeof(T));
     else
         for (I it = *range; it.ref < it.end; it.ref++)
             *it.ref = value;
@@ -304,7 +315,7 @@ static inline void JOIN(A, fill_n)(A *self, size_t n, T value)
         return;
 #if defined(POD) && !defined(NOT_INTEGRAL)
     if (sizeof(T) <= sizeof(char))
-        memset(self->vector, value, n * sizeof(T));
+        memset(self->vector, _ctl_byte(&value), n * sizeof(T));
     else
         for (size_t i = 0; i < n; i++)
             self->vector[i] = value;
@@ -398,41 +409,40 @@ static inline void JOIN(A, swap)(A *self, A *other)
     *other = temp;
 }
 
-static inline void JOIN(A, _ranged_sort)(A *self, size_t a, size_t b, int _compare(T *, T *))
+#include <ctl/bits/sort.h>
+
+#if defined(POD) && !defined(NOT_INTEGRAL)
+// Sorts integral types ascending by their value, ignoring compare.
+static inline void JOIN(A, sort_radix)(A *self)
 {
-    if (UNLIKELY(a >= b))
-        return;
-    // TODO insertion_sort cutoff
-    // long mid = (a + b) / 2; // overflow!
-    // Dietz formula http://aggregate.org/MAGIC/#Average%20of%20Integers
-    size_t mid = ((a ^ b) >> 1) + (a & b);
-    // LOG("sort \"%s\" %ld, %ld\n", self->vector, a, b);
-    SWAP(T, &self->vector[a], &self->vector[mid]);
-    size_t z = a;
-    // check overflow of a + 1
-    if (LIKELY(a + 1 > a))
-        for (size_t i = a + 1; i <= b; i++)
-            if (_compare(&self->vector[i], &self->vector[a]))
-            {
-                z++;
-                SWAP(T, &self->vector[z], &self->vector[i]);
-            }
-    SWAP(T, &self->vector[a], &self->vector[z]);
-    if (LIKELY(z))
-        JOIN(A, _ranged_sort)(self, a, z - 1, _compare);
-    // check overflow of z + 1
-    if (LIKELY(z + 1 > z))
-        JOIN(A, _ranged_sort)(self, z + 1, b, _compare);
+    if (N > 1 && !JOIN(A, _radix_sort)(self->vector, N))
+        JOIN(A, _ranged_sort)(self, 0, N - 1, _JOIN(A, _default_integral_compare));
 }
+#endif
 
 static inline void JOIN(A, sort)(A *self)
 {
     CTL_ASSERT_COMPARE
-    // TODO insertion_sort cutoff
+#if defined(POD) && !defined(NOT_INTEGRAL) && !defined(COMPARE)
+    if (N > CTL_SORT_RADIX && self->compare == _JOIN(A, _default_integral_compare) &&
+        !JOIN(A, _radix_presorted)(self->vector, N) && JOIN(A, _radix_sort)(self->vector, N))
+        return;
+#endif
     if (LIKELY(N > 1))
         JOIN(A, _ranged_sort)(self, 0, N - 1, self->compare);
 }
 
+#ifdef CTL_SORT_PARALLEL
+// Sorts with threads threads, 0 for CTL_SORT_THREADS or one per cpu. Small
+// arrays are sorted serially.
+static inline void JOIN(A, sort_parallel)(A *self, size_t threads)
+{
+    CTL_ASSERT_COMPARE
+    if (!JOIN(A, _sort_parallel)(self, N, self->compare, threads))
+        JOIN(A, sort)(self);
+}
+#endif
+
 static inline A JOIN(A, copy)(A *self)
 {
     A other = JOIN(A, init)();
@@ -447,6 +457,13 @@ static inline A JOIN(A, copy)(A *self)
 
 static inline T *JOIN(A, find)(A *self, T key)
 {
+#if defined(POD) && !defined(NOT_INTEGRAL)
+    if (JOIN(A, _simd)(self))
+    {
+        const size_t i = JOIN(A, _simd_find)(&self->vector[0], N, key, true);
+        return i < N ? &self->vector[i] : NULL;
+    }
+#endif
     foreach (A, self, it)
         if (JOIN(A, _equal)(self, it.ref, &key))
             return it.ref;
@@ -552,11 +569,11 @@ static inline I JOIN(A, intersection_range)(I *r1, GI *r2)
 
     while (!JOIN(I, done)(r1) && !done2(r2))
     {
-        if (self->compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self->compare, r1->ref, ref2(r2)))
             JOIN(I, next)(r1);
         else
         {
-            if (!self->compare(ref2(r2), r1->ref))
+            if (!_CTL_COMPARE(self->compare, ref2(r2), r1->ref))
             {
                 *it.ref = self->copy(r1->ref);
                 JOIN(I, next)(&it);
@@ -593,7 +610,7 @@ static inline I JOIN(A, difference_range)(I *r1, I *r2)
         if (done2(r2))
             return JOIN(A, copy_range)(&it, r1);
         // r1 < r2 (fails with 3-way compare)
-        if (self->compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self->compare, r1->ref, ref2(r2)))
         {
             *it.ref = self->copy(r1->ref);
             JOIN(I, next)(&it);
@@ -601,7 +618,7 @@ static inline I JOIN(A, difference_range)(I *r1, I *r2)
         }
         else
         {
-            if (!self->compare(ref2(r2), r1->ref))
+            if (!_CTL_COMPARE(self->compare, ref2(r2), r1->ref))
                 JOIN(I, next)(r1);
             next2(r2);
         }
@@ -632,7 +649,7 @@ static inline I JOIN(A, symmetric_difference_range)(I *r1, GI *r2)
     {
         if (done2(r2))
             return JOIN(A, copy_range)(&it, r1);
-        if (self->compare(r1->ref, ref2(r2)))
+        if (_CTL_COMPARE(self->compare, r1->ref, ref2(r2)))
         {
             *it.ref = self->copy(r1->ref);
             JOIN(I, next)(&it);
@@ -640,7 +657,7 @@ static inline I JOIN(A, symmetric_difference_range)(I *r1, GI *r2)
         }
         else
         {
-            if (self->compare(ref2(r2), r1->ref))
+            if (_CTL_COMPARE(self->compare, ref2(r2), r1->ref))
             {
                 *it.ref = self->copy(ref2(r2));
                 JOIN(I, next)(&it);
@@ -662,5 +679,7 @@ static inline I JOIN(A, symmetric_difference_range)(I *r1, GI *r2)
 #undef C
 #undef T
 #undef POD
+#undef COMPARE
+#undef EQUAL
 #undef NOT_INTEGRAL
 #undef CTL_ARR
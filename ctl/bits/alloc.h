@@ -0,0 +1,42 @@
+/* Allocation hooks of vec, str, deq, list, set and uset.
+   SPDX-License-Identifier: MIT
+
+   Define all three before including a container, as with COMPARE they are
+   per instantiation and undefined after it:
+
+       #define CTL_ALLOC(size) arena_alloc(&arena, size)
+       #define CTL_REALLOC(ptr, size) arena_realloc(&arena, ptr, size)
+       #define CTL_FREE(ptr) arena_free(&arena, ptr)
+
+   Temporary buffers, as of the sorts, still use malloc.
+ */
+
+// DO NOT STANDALONE INCLUDE.
+#ifndef CTL_ALLOC
+#if defined CTL_REALLOC || defined CTL_FREE
+#error "CTL_REALLOC or CTL_FREE without CTL_ALLOC"
+#endif
+#define CTL_ALLOC(size) malloc(size)
+#define CTL_REALLOC(ptr, size) realloc(ptr, size)
+#define CTL_FREE(ptr) free(ptr)
+#define _CTL_CALLOC(count, size) calloc(count, size)
+#define _CTL_ALLOC_DEFAULT
+#else
+#if !defined CTL_REALLOC || !defined CTL_FREE
+#error "CTL_ALLOC needs CTL_REALLOC and CTL_FREE"
+#endif
+#define _CTL_CALLOC(count, size) _ctl_zeroed(CTL_ALLOC((count) * (size)), (count) * (size))
+#endif
+
+#ifndef _CTL_ALLOC_H
+#define _CTL_ALLOC_H
+#include <stdlib.h>
+#include <string.h>
+
+static inline void *_ctl_zeroed(void *ptr, size_t size)
+{
+    if (ptr)
+        memset(ptr, 0, size);
+    return ptr;
+}
+#endif
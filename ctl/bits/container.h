@@ -35,7 +35,8 @@ static inline size_t JOIN(A, size)(A *self)
 
 static inline size_t JOIN(A, max_size)(void)
 {
-    return 4294967296 / sizeof(T); // 32bit at most. avoid DDOS
+    // 32bit at most by default. avoid DDOS
+    return CTL_MAX_SIZE / sizeof(T) < SIZE_MAX ? (size_t)(CTL_MAX_SIZE / sizeof(T)) : SIZE_MAX;
 }
 #endif
 
@@ -56,27 +57,28 @@ static inline T JOIN(A, implicit_copy)(T *self)
 
 // not valid for uset, str
 #if !defined(CTL_USET) && !defined(CTL_STR) && !defined(CTL_SLIST)
+static inline int JOIN(A, _equal)(A *self, T *a, T *b);
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+static inline bool JOIN(A, _simd)(A *self);
+static inline size_t JOIN(A, _simd_mismatch)(T *a, T *b, size_t n);
+#endif
+
 static inline int JOIN(A, equal)(A* self, A* other)
 {
     if (JOIN(A, size)(self) != JOIN(A, size)(other))
         return 0;
     I i1 = JOIN(A, begin)(self);
     I i2 = JOIN(A, begin)(other);
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+    if (JOIN(A, _simd)(self))
+        return JOIN(A, _simd_mismatch)(i1.ref, i2.ref, JOIN(A, size)(self)) == JOIN(A, size)(self);
+#endif
     while (!JOIN(I, done)(&i1) && !JOIN(I, done)(&i2))
     {
         T *r1 = JOIN(I, ref)(&i1);
         T *r2 = JOIN(I, ref)(&i2);
-        if (self->equal)
-        {
-            if (!self->equal(r1, r2))
-                return 0;
-        }
-        else
-        {
-            // this works with 2-way and 3-way compare
-            if (self->compare(r1, r2) || self->compare(r2, r1))
-                return 0;
-        }
+        if (!JOIN(A, _equal)(self, r1, r2))
+            return 0;
         JOIN(I, next)(&i1);
         JOIN(I, next)(&i2);
     }
@@ -86,15 +88,28 @@ static inline int JOIN(A, equal)(A* self, A* other)
 
 // _set_default_methods
 #include <ctl/bits/integral.h>
+#include <ctl/bits/simd.h>
 
 #if !defined(CTL_USET)
 static inline int JOIN(A, _equal)(A *self, T *a, T *b)
 {
+#ifdef EQUAL
+    (void)self;
+    return EQUAL(a, b);
+#else
+#ifndef COMPARE
     CTL_ASSERT_EQUAL
+#endif
+#if defined(POD) && !defined(NOT_INTEGRAL)
+    if (self->equal == _JOIN(A, _default_integral_equal))
+        return *a == *b;
+#endif
     if (self->equal)
         return self->equal(a, b);
     else
-        return !self->compare(a, b) && !self->compare(b, a);
+        // this works with 2-way and 3-way compare
+        return !_CTL_COMPARE(self->compare, a, b) && !_CTL_COMPARE(self->compare, b, a);
+#endif
 }
 #endif
 
@@ -0,0 +1,133 @@
+/* Default hash functions, once per translation unit.
+   A wyhash-style multiply-fold hash: word-at-a-time over strings, and a
+   single 64x64->128 bit multiply to mix integers.
+   SPDX-License-Identifier: MIT */
+
+#ifndef __CTL_HASH_H__
+#define __CTL_HASH_H__
+
+#include <stdint.h>
+#include <string.h>
+
+// the wyhash secrets
+#define CTL_HASH_P0 UINT64_C(0x2d358dccaa6c78a5)
+#define CTL_HASH_P1 UINT64_C(0x8bb84b93962eacc9)
+#define CTL_HASH_P2 UINT64_C(0x4b33a62ed433d4a3)
+#define CTL_HASH_P3 UINT64_C(0x4d5a2da51de1aa47)
+
+// the 128 bit product of a and b: returns the low, and sets the high half.
+static inline uint64_t ctl_hash_mul128(uint64_t a, uint64_t b, uint64_t *hi)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 ctl_uint128;
+    const ctl_uint128 r = (ctl_uint128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    const uint64_t lo = t + (rm1 << 32);
+    *hi = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+    return lo;
+#endif
+}
+
+// the 128 bit product of a and b, folded to 64 bit.
+static inline uint64_t ctl_hash_mix(uint64_t a, uint64_t b)
+{
+    uint64_t hi;
+    const uint64_t lo = ctl_hash_mul128(a, b, &hi);
+    return lo ^ hi;
+}
+
+// Maps hash to [0, n) by a multiply-shift (fastrange), without a division.
+// Uses the high bits of the hash, which must be well mixed.
+static inline size_t ctl_fastrange(size_t hash, size_t n)
+{
+#if SIZE_MAX > UINT32_MAX
+    uint64_t hi;
+    ctl_hash_mul128(hash, n, &hi);
+    return (size_t)hi;
+#else
+    return (size_t)(((uint64_t)hash * n) >> 32);
+#endif
+}
+
+static inline uint64_t ctl_hash_read8(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t ctl_hash_read4(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// Integers: all bits of the key reach the low bits of the hash, as needed
+// by the power of 2 masking.
+static inline size_t ctl_hash_int(uint64_t key)
+{
+    return (size_t)ctl_hash_mix(key ^ CTL_HASH_P0, CTL_HASH_P1);
+}
+
+static inline size_t ctl_hash_bytes(const void *key, size_t len, uint64_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t a, b;
+    seed ^= ctl_hash_mix(seed ^ CTL_HASH_P0, CTL_HASH_P1);
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            const size_t mid = (len >> 3) << 2;
+            a = (ctl_hash_read4(p) << 32) | ctl_hash_read4(p + mid);
+            b = (ctl_hash_read4(p + len - 4) << 32) | ctl_hash_read4(p + len - 4 - mid);
+        }
+        else if (len > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            uint64_t seed1 = seed, seed2 = seed;
+            do
+            {
+                seed = ctl_hash_mix(ctl_hash_read8(p) ^ CTL_HASH_P1, ctl_hash_read8(p + 8) ^ seed);
+                seed1 = ctl_hash_mix(ctl_hash_read8(p + 16) ^ CTL_HASH_P2, ctl_hash_read8(p + 24) ^ seed1);
+                seed2 = ctl_hash_mix(ctl_hash_read8(p + 32) ^ CTL_HASH_P3, ctl_hash_read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16)
+        {
+            seed = ctl_hash_mix(ctl_hash_read8(p) ^ CTL_HASH_P1, ctl_hash_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = ctl_hash_read8(p + i - 16);
+        b = ctl_hash_read8(p + i - 8);
+    }
+    return (size_t)ctl_hash_mix(ctl_hash_mix(a ^ CTL_HASH_P1, b ^ seed) ^ len, CTL_HASH_P0);
+}
+
+// NUL-terminated strings. strlen is word-at-a-time in the libc.
+static inline size_t ctl_hash_str(const char *s)
+{
+    return ctl_hash_bytes(s, strlen(s), 0);
+}
+
+#endif // __CTL_HASH_H__
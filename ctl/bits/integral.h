@@ -14,6 +14,8 @@ _define_integral_compare(long)
 #undef _define_integral_compare
 */
 
+#include <ctl/bits/hash.h>
+
 #if defined(POD) && !defined(NOT_INTEGRAL)
 
 static inline int _JOIN(A, _default_integral_compare3)(T *a, T *b)
@@ -34,26 +36,37 @@ static inline int _JOIN(A, _default_integral_equal)(T *a, T *b)
     */
 }
 
+#include <float.h>
+#include <string.h>
+
+// not the identity, which is bad with CTL_USET_GROWTH_POWER2 masking.
+// floats by their bits, not truncated, with -0.0 as 0.0
 static inline size_t _JOIN(A, _default_integral_hash)(T *a)
 {
-    return (size_t)*a;
+    if (_CTL_IS_FLOAT(T))
+    {
+        T v = *a == (T)0 ? (T)0 : *a;
+        uint64_t bits = 0;
+        if (sizeof(T) <= sizeof(bits))
+        {
+            memcpy(&bits, &v, sizeof(T) < sizeof(bits) ? sizeof(T) : sizeof(bits));
+            return ctl_hash_int(bits);
+        }
+        // the x87 long double has 6 bytes of padding
+        return ctl_hash_bytes(&v, LDBL_MANT_DIG == 64 && sizeof(T) > 10 ? 10 : sizeof(T), 0);
+    }
+    return ctl_hash_int((uint64_t)(int64_t)*a);
 }
 
-#include <string.h>
-
 #if defined str || defined u8string || defined charp || defined u8ident || defined ucharp
 
 static inline size_t _JOIN(A, _default_string_hash)(T *key)
 {
-    size_t h;
-    /* FNV1a, not wyhash */
-    h = 2166136261u;
-    for (unsigned i = 0; i < strlen((char *)key); i++)
-    {
-        h ^= (unsigned char)key[i];
-        h *= 16777619;
-    }
-    return h;
+#if defined str || defined u8string
+    return ctl_hash_bytes(JOIN(T, data)(key), key->size, 0);
+#else
+    return ctl_hash_str(*(char **)key);
+#endif
 }
 
 #endif
@@ -118,6 +131,11 @@ static inline void _JOIN(A, _set_default_methods)(A *self)
 #ifdef CTL_USET
         if (!self->hash)
             self->hash = _JOIN(A, _default_integral_hash);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    if (!self->compare)
+        self->compare = _JOIN(A, _default_integral_compare);
+#endif
 #else
     if (!self->compare)
         self->compare = _JOIN(A, _default_integral_compare);
@@ -135,3 +153,24 @@ static inline void _JOIN(A, _set_default_methods)(A *self)
 }
 
 #endif
+
+// Compile-time compare and equal hooks, expanded inline instead of calling the
+// compare and equal methods through their function pointers. Per instantiation:
+//   #define COMPARE(a, b) (*(a) < *(b))
+//   #define EQUAL(a, b) (*(a) == *(b)) // optional
+// on T *a, T *b. Without COMPARE integral types still inline their default
+// operator<, unless another compare method was set.
+#undef _CTL_COMPARE
+#undef CTL_ASSERT_COMPARE
+#if defined COMPARE
+#define _CTL_COMPARE(compare, a, b) ((void)(compare), COMPARE(a, b))
+#define CTL_ASSERT_COMPARE
+#elif defined(POD) && !defined(NOT_INTEGRAL)
+#define _CTL_COMPARE(compare, a, b)                                                                                    \
+    ((compare) == _JOIN(A, _default_integral_compare) ? *(a) < *(b) : (compare)(a, b))
+#else
+#define _CTL_COMPARE(compare, a, b) (compare)(a, b)
+#endif
+#ifndef CTL_ASSERT_COMPARE
+#define CTL_ASSERT_COMPARE ASSERT(self->compare || !"compare undefined");
+#endif
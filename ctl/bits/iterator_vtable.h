@@ -30,6 +30,20 @@
     B **buckets; /* the chain. no end range needed for uset */                                                         \
     B *node
 
+#define CTL_SWISS_ITER_FIELDS                                                                                          \
+    struct JOIN(I, vtable_t) vtable;                                                                                   \
+    T *ref; /* NULL at the end */                                                                                      \
+    A *container;                                                                                                      \
+    uintptr_t end; /* no ranges */                                                                                     \
+    size_t index
+
+#define CTL_HMAP_ITER_FIELDS                                                                                           \
+    struct JOIN(I, vtable_t) vtable;                                                                                   \
+    T *ref; /* NULL at the end */                                                                                      \
+    A *container;                                                                                                      \
+    uintptr_t end; /* no ranges */                                                                                     \
+    size_t index
+
 #define CTL_DEQ_ITER_FIELDS                                                                                            \
     struct JOIN(I, vtable_t) vtable;                                                                                   \
     T *ref; /* will be removed later */                                                                                \
@@ -49,10 +49,24 @@
 
 #ifndef CTL_DEQ
 
+#ifdef __cplusplus
+#define _CTL_ALIGNOF(T) alignof(T)
+#elif defined __STDC_VERSION__ && __STDC_VERSION__ >= 201112L
+#define _CTL_ALIGNOF(T) _Alignof(T)
+#else
+#define _CTL_ALIGNOF(T) __alignof__(T)
+#endif
+/* The elements of a vec, or of a small_vector or str. Their vector is NULL
+   while the elements are kept inline in small[], right after the capacity. */
+#define _ctl_vec_data(T, self)                                                                                         \
+    ((self)->vector ? (self)->vector                                                                                   \
+                    : (T *)(((uintptr_t)(&(self)->capacity + 1) + _CTL_ALIGNOF(T) - 1) &                               \
+                            ~(uintptr_t)(_CTL_ALIGNOF(T) - 1)))
+
 /* Make simple vector iters fast */
 #define vec_foreach(T, self, ref)                                                                                      \
     if ((self)->size)                                                                                                  \
-        for (T *ref = &(self)->vector[0]; ref < &(self)->vector[(self)->size]; ref++)
+        for (T *ref = _ctl_vec_data(T, self); ref < &_ctl_vec_data(T, self)[(self)->size]; ref++)
 #define vec_foreach_range(T, self, it, first, last)                                                                    \
     if ((self)->size && last.ref)                                                                                      \
         for (T *it = first.ref; it < last.ref; it++)
@@ -0,0 +1,203 @@
+/* SIMD find, count and mismatch for the contiguous integral containers.
+   SPDX-License-Identifier: MIT
+
+   For POD integral vec, svec, str, pqu and arr instantiations with the default
+   equal method, with bool, 1, 2, 4 and 8 byte integers, float and double. One
+   compare tests a whole register, chosen at compile time:
+
+  - AVX2:      32 bytes per compare (`__AVX2__`)
+  - SSE2:      16 bytes per compare (`__SSE2__`)
+  - portable:  one element per compare.
+
+   find and mismatch test two registers per step. The str byte sets need
+   SSSE3 shuffles with 16 byte registers. Floats compare as floats,
+   NaN never equal. Define CTL_NO_SIMD before the first container for the
+   portable loops.
+*/
+
+// DO NOT STANDALONE INCLUDE.
+#ifndef __CTL_SIMD_H__
+#define __CTL_SIMD_H__
+
+#if defined __AVX2__ && !defined CTL_NO_SIMD
+#include <immintrin.h>
+#define CTL_SIMD_WIDTH 32
+typedef __m256i _ctl_simd_t;
+#define _ctl_simd_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define _ctl_simd_mask(x) ((uint64_t)(uint32_t)_mm256_movemask_epi8(x))
+#elif defined __SSE2__ && !defined CTL_NO_SIMD
+#include <emmintrin.h>
+#define CTL_SIMD_WIDTH 16
+typedef __m128i _ctl_simd_t;
+#define _ctl_simd_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define _ctl_simd_mask(x) ((uint64_t)(uint32_t)_mm_movemask_epi8(x))
+#else
+#define CTL_SIMD_WIDTH 0
+#endif
+// all bytes of one register set
+#define _CTL_SIMD_ALL ((UINT64_C(1) << CTL_SIMD_WIDTH) - 1)
+// byte shuffles for table lookups, as by the byte sets of str
+#if CTL_SIMD_WIDTH == 32 || (CTL_SIMD_WIDTH == 16 && defined __SSSE3__)
+#if CTL_SIMD_WIDTH == 16
+#include <tmmintrin.h>
+#endif
+#define _CTL_SIMD_SHUFFLE
+#endif
+
+#endif // __CTL_SIMD_H__
+
+#if (defined CTL_VEC || defined CTL_ARR) && defined POD && !defined NOT_INTEGRAL
+
+#include <stdint.h>
+#include <string.h>
+
+// The integers, bool, float and double. Not long double, nor pointers.
+static inline bool JOIN(A, _simd_type)(void)
+{
+    return (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) &&
+           (!_CTL_IS_FLOAT(T) || sizeof(T) >= 4) && !_CTL_IS_POINTER(T);
+}
+
+// equal is plain ==
+static inline bool JOIN(A, _simd)(A *self)
+{
+#ifdef EQUAL
+    (void)self;
+    return false;
+#else
+    return self->equal == _JOIN(A, _default_integral_equal) && JOIN(A, _simd_type)();
+#endif
+}
+
+#if CTL_SIMD_WIDTH
+
+static inline _ctl_simd_t JOIN(A, _simd_set1)(T value)
+{
+    uint64_t v = 0;
+    memcpy(&v, &value, sizeof(T) < sizeof(v) ? sizeof(T) : sizeof(v));
+#if CTL_SIMD_WIDTH == 32
+    return sizeof(T) == 1   ? _mm256_set1_epi8((char)v)
+           : sizeof(T) == 2 ? _mm256_set1_epi16((short)v)
+           : sizeof(T) == 4 ? _mm256_set1_epi32((int)v)
+                            : _mm256_set1_epi64x((long long)v);
+#else
+    return sizeof(T) == 1   ? _mm_set1_epi8((char)v)
+           : sizeof(T) == 2 ? _mm_set1_epi16((short)v)
+           : sizeof(T) == 4 ? _mm_set1_epi32((int)v)
+                            : _mm_set1_epi64x((long long)v);
+#endif
+}
+
+// all bytes of the equal elements set
+static inline _ctl_simd_t JOIN(A, _simd_eq)(_ctl_simd_t a, _ctl_simd_t b)
+{
+#if CTL_SIMD_WIDTH == 32
+    if (_CTL_IS_FLOAT(T))
+        return sizeof(T) == 4
+                   ? _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))
+                   : _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    return sizeof(T) == 1   ? _mm256_cmpeq_epi8(a, b)
+           : sizeof(T) == 2 ? _mm256_cmpeq_epi16(a, b)
+           : sizeof(T) == 4 ? _mm256_cmpeq_epi32(a, b)
+                            : _mm256_cmpeq_epi64(a, b);
+#else
+    if (_CTL_IS_FLOAT(T))
+        return sizeof(T) == 4 ? _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))
+                              : _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    if (sizeof(T) == 8) // no SSE2 cmpeq_epi64: both halves equal
+    {
+        const __m128i e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    return sizeof(T) == 1 ? _mm_cmpeq_epi8(a, b) : sizeof(T) == 2 ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b);
+#endif
+}
+
+#endif // CTL_SIMD_WIDTH
+
+// The index of the first element equal to value, or with !equal the first
+// unequal one. n if none.
+static inline size_t JOIN(A, _simd_find)(T *p, size_t n, T value, bool equal)
+{
+    size_t i = 0;
+#if CTL_SIMD_WIDTH
+    if (JOIN(A, _simd_type)())
+    {
+        const size_t step = CTL_SIMD_WIDTH / sizeof(T);
+        const _ctl_simd_t v = JOIN(A, _simd_set1)(value);
+        const uint64_t flip = equal ? 0 : _CTL_SIMD_ALL;
+        for (; i + 2 * step <= n; i += 2 * step)
+        {
+            const uint64_t m = (_ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&p[i]), v)) ^ flip) |
+                               (_ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&p[i + step]), v)) ^ flip)
+                                   << CTL_SIMD_WIDTH;
+            if (m)
+                return i + __builtin_ctzll(m) / sizeof(T);
+        }
+        for (; i + step <= n; i += step)
+        {
+            const uint64_t m = _ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&p[i]), v)) ^ flip;
+            if (m)
+                return i + __builtin_ctzll(m) / sizeof(T);
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if ((p[i] == value) == equal)
+            return i;
+    return n;
+}
+
+static inline size_t JOIN(A, _simd_count)(T *p, size_t n, T value)
+{
+    size_t i = 0, count = 0;
+#if CTL_SIMD_WIDTH
+    if (JOIN(A, _simd_type)())
+    {
+        const size_t step = CTL_SIMD_WIDTH / sizeof(T);
+        const _ctl_simd_t v = JOIN(A, _simd_set1)(value);
+        size_t bits = 0;
+        for (; i + step <= n; i += step)
+            bits += __builtin_popcountll(_ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&p[i]), v)));
+        count = bits / sizeof(T);
+    }
+#endif
+    for (; i < n; i++)
+        count += p[i] == value;
+    return count;
+}
+
+// The index of the first unequal pair of a and b, or n
+static inline size_t JOIN(A, _simd_mismatch)(T *a, T *b, size_t n)
+{
+    size_t i = 0;
+#if CTL_SIMD_WIDTH
+    if (JOIN(A, _simd_type)())
+    {
+        const size_t step = CTL_SIMD_WIDTH / sizeof(T);
+        for (; i + 2 * step <= n; i += 2 * step)
+        {
+            const uint64_t m =
+                (_ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&a[i]), _ctl_simd_load(&b[i]))) ^ _CTL_SIMD_ALL) |
+                (_ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&a[i + step]), _ctl_simd_load(&b[i + step]))) ^
+                 _CTL_SIMD_ALL)
+                    << CTL_SIMD_WIDTH;
+            if (m)
+                return i + __builtin_ctzll(m) / sizeof(T);
+        }
+        for (; i + step <= n; i += step)
+        {
+            const uint64_t m =
+                _ctl_simd_mask(JOIN(A, _simd_eq)(_ctl_simd_load(&a[i]), _ctl_simd_load(&b[i]))) ^ _CTL_SIMD_ALL;
+            if (m)
+                return i + __builtin_ctzll(m) / sizeof(T);
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if (!(a[i] == b[i]))
+            return i;
+    return n;
+}
+
+#endif // VEC, ARR
@@ -0,0 +1,712 @@
+/* Pattern-defeating quicksort for the random access containers.
+   SPDX-License-Identifier: MIT
+
+   After pdqsort by Orson Peters: a quicksort with median-of-3 (ninther for
+   large ranges) pivots, insertion sort for small ranges, and a heapsort
+   fallback after too many unbalanced partitions, i.e. at most O(n log n).
+   Runs of elements equal to the previous pivot are partitioned off in one
+   pass, which keeps many duplicates linear, and already partitioned ranges
+   are finished by an insertion sort which gives up early. So sorted,
+   reversed and all-equal input is O(n).
+
+   stable_sort is a bottom-up merge sort with a buffer, linear with presorted
+   runs.
+
+   Integral POD vectors and arrays above CTL_SORT_RADIX elements are sorted by
+   a LSD radix sort instead, when they use the default compare.
+
+   With CTL_SORT_PARALLEL defined, sort_parallel is a sample sort on pthreads.
+   Link with -pthread then.
+ */
+
+// DO NOT STANDALONE INCLUDE.
+#if !defined CTL_VEC && \
+    !defined CTL_ARR && \
+    !defined CTL_DEQ
+#error "No random access CTL container defined for <ctl/bits/sort.h>"
+#endif
+
+#include <stdbool.h>
+
+// below this size use insertion sort
+#ifndef CTL_SORT_INSERTION
+#define CTL_SORT_INSERTION 24
+#endif
+// above this size choose the pivot by the median of 3 medians
+#ifndef CTL_SORT_NINTHER
+#define CTL_SORT_NINTHER 128
+#endif
+// partial insertion sort gives up after this many moved elements
+#define CTL_SORT_PARTIAL_LIMIT 8
+
+#ifdef CTL_DEQ
+#define _CTL_SORT_AT(i) JOIN(A, at)(self, i)
+#elif defined CTL_SVEC || defined CTL_STR
+#define _CTL_SORT_AT(i) (&_CTL_VEC_DATA(self)[i])
+#else
+#define _CTL_SORT_AT(i) (&self->vector[i])
+#endif
+#define _CTL_SORT_SWAP(i, j) SWAP(T, _CTL_SORT_AT(i), _CTL_SORT_AT(j))
+// inlined with COMPARE or the default integral compare
+#define _CTL_SORT_LESS(a, b) _CTL_COMPARE(_compare, a, b)
+
+// excluding to
+static inline void JOIN(A, _insertion_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    for (size_t i = from + 1; i < to; i++)
+    {
+        if (!_CTL_SORT_LESS(_CTL_SORT_AT(i), _CTL_SORT_AT(i - 1)))
+            continue;
+        T tmp = *_CTL_SORT_AT(i);
+        size_t j = i;
+        do
+        {
+            *_CTL_SORT_AT(j) = *_CTL_SORT_AT(j - 1);
+            j--;
+        } while (j > from && _CTL_SORT_LESS(&tmp, _CTL_SORT_AT(j - 1)));
+        *_CTL_SORT_AT(j) = tmp;
+    }
+}
+
+// As above, but gives up after CTL_SORT_PARTIAL_LIMIT moves, when the range
+// looks unsorted. Returns true if sorted.
+static inline bool JOIN(A, _partial_insertion_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    size_t moves = 0;
+    for (size_t i = from + 1; i < to; i++)
+    {
+        if (!_CTL_SORT_LESS(_CTL_SORT_AT(i), _CTL_SORT_AT(i - 1)))
+            continue;
+        T tmp = *_CTL_SORT_AT(i);
+        size_t j = i;
+        do
+        {
+            *_CTL_SORT_AT(j) = *_CTL_SORT_AT(j - 1);
+            j--;
+        } while (j > from && _CTL_SORT_LESS(&tmp, _CTL_SORT_AT(j - 1)));
+        *_CTL_SORT_AT(j) = tmp;
+        moves += i - j;
+        if (moves > CTL_SORT_PARTIAL_LIMIT)
+            return false;
+    }
+    return true;
+}
+
+// sorts the 3 elements, the median ends up at b
+static inline void JOIN(A, _sort3)(A *self, size_t a, size_t b, size_t c, int _compare(T *, T *))
+{
+    if (_CTL_SORT_LESS(_CTL_SORT_AT(b), _CTL_SORT_AT(a)))
+        _CTL_SORT_SWAP(a, b);
+    if (_CTL_SORT_LESS(_CTL_SORT_AT(c), _CTL_SORT_AT(b)))
+    {
+        _CTL_SORT_SWAP(b, c);
+        if (_CTL_SORT_LESS(_CTL_SORT_AT(b), _CTL_SORT_AT(a)))
+            _CTL_SORT_SWAP(a, b);
+    }
+}
+
+static inline void JOIN(A, _sift_down)(A *self, size_t from, size_t root, size_t size, int _compare(T *, T *))
+{
+    for (;;)
+    {
+        size_t child = 2 * root + 1;
+        if (child >= size)
+            return;
+        if (child + 1 < size && _CTL_SORT_LESS(_CTL_SORT_AT(from + child), _CTL_SORT_AT(from + child + 1)))
+            child++;
+        if (!_CTL_SORT_LESS(_CTL_SORT_AT(from + root), _CTL_SORT_AT(from + child)))
+            return;
+        _CTL_SORT_SWAP(from + root, from + child);
+        root = child;
+    }
+}
+
+// the O(n log n) fallback, excluding to
+static inline void JOIN(A, _heap_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    const size_t size = to - from;
+    for (size_t i = size / 2; i-- > 0;)
+        JOIN(A, _sift_down)(self, from, i, size, _compare);
+    for (size_t i = size - 1; i > 0; i--)
+    {
+        _CTL_SORT_SWAP(from, from + i);
+        JOIN(A, _sift_down)(self, from, 0, i, _compare);
+    }
+}
+
+// Partitions [from, to) around the pivot at from, the elements equal to it go
+// right. Returns the final pivot position, and sets *partitioned when no
+// element had to be swapped. Needs an element not less than the pivot after
+// it, which the pivot selection guarantees.
+static inline size_t JOIN(A, _partition_right)(A *self, size_t from, size_t to, int _compare(T *, T *),
+                                               bool *partitioned)
+{
+    T pivot = *_CTL_SORT_AT(from);
+    size_t first = from;
+    size_t last = to;
+    while (_CTL_SORT_LESS(_CTL_SORT_AT(++first), &pivot))
+        ;
+    if (first - 1 == from)
+        while (first < last && !_CTL_SORT_LESS(_CTL_SORT_AT(--last), &pivot))
+            ;
+    else
+        while (!_CTL_SORT_LESS(_CTL_SORT_AT(--last), &pivot))
+            ;
+    *partitioned = first >= last;
+    while (first < last)
+    {
+        _CTL_SORT_SWAP(first, last);
+        while (_CTL_SORT_LESS(_CTL_SORT_AT(++first), &pivot))
+            ;
+        while (!_CTL_SORT_LESS(_CTL_SORT_AT(--last), &pivot))
+            ;
+    }
+    const size_t pivot_pos = first - 1;
+    *_CTL_SORT_AT(from) = *_CTL_SORT_AT(pivot_pos);
+    *_CTL_SORT_AT(pivot_pos) = pivot;
+    return pivot_pos;
+}
+
+// Partitions [from, to) around the pivot at from, the elements equal to it go
+// left. Used when the pivot equals the element before the range, so that no
+// element is less: the left part is all equal and done then.
+static inline size_t JOIN(A, _partition_left)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    T pivot = *_CTL_SORT_AT(from);
+    size_t first = from;
+    size_t last = to;
+    while (_CTL_SORT_LESS(&pivot, _CTL_SORT_AT(--last)))
+        ;
+    if (last + 1 == to)
+        while (first < last && !_CTL_SORT_LESS(&pivot, _CTL_SORT_AT(++first)))
+            ;
+    else
+        while (!_CTL_SORT_LESS(&pivot, _CTL_SORT_AT(++first)))
+            ;
+    while (first < last)
+    {
+        _CTL_SORT_SWAP(first, last);
+        while (_CTL_SORT_LESS(&pivot, _CTL_SORT_AT(--last)))
+            ;
+        while (!_CTL_SORT_LESS(&pivot, _CTL_SORT_AT(++first)))
+            ;
+    }
+    *_CTL_SORT_AT(from) = *_CTL_SORT_AT(last);
+    *_CTL_SORT_AT(last) = pivot;
+    return last;
+}
+
+// swaps some elements around, against patterns causing bad pivots
+static inline void JOIN(A, _break_patterns)(A *self, size_t from, size_t to)
+{
+    const size_t size = to - from;
+    if (size < CTL_SORT_INSERTION)
+        return;
+    const size_t q = size / 4;
+    _CTL_SORT_SWAP(from, from + q);
+    _CTL_SORT_SWAP(to - 1, to - q);
+    if (size > CTL_SORT_NINTHER)
+    {
+        _CTL_SORT_SWAP(from + 1, from + q + 1);
+        _CTL_SORT_SWAP(from + 2, from + q + 2);
+        _CTL_SORT_SWAP(to - 2, to - q - 1);
+        _CTL_SORT_SWAP(to - 3, to - q - 2);
+    }
+}
+
+// Excluding to. bad_allowed unbalanced partitions are tolerated before the
+// heapsort. leftmost: there is no element before from in the whole sort.
+static inline void JOIN(A, _pdqsort)(A *self, size_t from, size_t to, int _compare(T *, T *), int bad_allowed,
+                                     bool leftmost)
+{
+    for (;;)
+    {
+        const size_t size = to - from;
+        if (size < CTL_SORT_INSERTION)
+        {
+            JOIN(A, _insertion_sort)(self, from, to, _compare);
+            return;
+        }
+        // the pivot goes to from
+        const size_t half = size / 2;
+        if (size > CTL_SORT_NINTHER)
+        {
+            JOIN(A, _sort3)(self, from, from + half, to - 1, _compare);
+            JOIN(A, _sort3)(self, from + 1, from + half - 1, to - 2, _compare);
+            JOIN(A, _sort3)(self, from + 2, from + half + 1, to - 3, _compare);
+            JOIN(A, _sort3)(self, from + half - 1, from + half, from + half + 1, _compare);
+            _CTL_SORT_SWAP(from, from + half);
+        }
+        else
+            JOIN(A, _sort3)(self, from + half, from, to - 1, _compare);
+        // the pivot equals the previous one: skip all equal elements
+        if (!leftmost && !_CTL_SORT_LESS(_CTL_SORT_AT(from - 1), _CTL_SORT_AT(from)))
+        {
+            from = JOIN(A, _partition_left)(self, from, to, _compare) + 1;
+            continue;
+        }
+        bool partitioned;
+        const size_t pivot = JOIN(A, _partition_right)(self, from, to, _compare, &partitioned);
+        const size_t left = pivot - from;
+        const size_t right = to - pivot - 1;
+        if (left < size / 8 || right < size / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                JOIN(A, _heap_sort)(self, from, to, _compare);
+                return;
+            }
+            JOIN(A, _break_patterns)(self, from, pivot);
+            JOIN(A, _break_patterns)(self, pivot + 1, to);
+        }
+        // mostly sorted
+        else if (partitioned && JOIN(A, _partial_insertion_sort)(self, from, pivot, _compare) &&
+                 JOIN(A, _partial_insertion_sort)(self, pivot + 1, to, _compare))
+            return;
+        // recurse into the smaller part, so the stack stays O(log n)
+        if (left < right)
+        {
+            JOIN(A, _pdqsort)(self, from, pivot, _compare, bad_allowed, leftmost);
+            from = pivot + 1;
+            leftmost = false;
+        }
+        else
+        {
+            JOIN(A, _pdqsort)(self, pivot + 1, to, _compare, bad_allowed, false);
+            to = pivot;
+        }
+    }
+}
+
+// including to
+static inline void JOIN(A, _ranged_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    if (UNLIKELY(from >= to))
+        return;
+    int bad_allowed = 0;
+    for (size_t size = to - from + 1; size > 1; size >>= 1)
+        bad_allowed++;
+    JOIN(A, _pdqsort)(self, from, to + 1, _compare, bad_allowed, true);
+}
+
+// the stable sort merges runs of this size, sorted by insertion sort
+#ifndef CTL_STABLE_SORT_RUN
+#define CTL_STABLE_SORT_RUN 32
+#endif
+
+// Stable merge of the sorted [from, mid) and [mid, to). The smaller part goes
+// to the buffer, then they are merged forwards or backwards.
+static inline void JOIN(A, _merge)(A *self, size_t from, size_t mid, size_t to, T *buffer,
+                                   int _compare(T *, T *))
+{
+    // already in order, as in presorted input
+    if (!_CTL_SORT_LESS(_CTL_SORT_AT(mid), _CTL_SORT_AT(mid - 1)))
+        return;
+    // skip the left elements not greater than the first right one, and the
+    // right elements not less than the last left one
+    while (!_CTL_SORT_LESS(_CTL_SORT_AT(mid), _CTL_SORT_AT(from)))
+        from++;
+    while (!_CTL_SORT_LESS(_CTL_SORT_AT(to - 1), _CTL_SORT_AT(mid - 1)))
+        to--;
+    if (mid - from <= to - mid)
+    {
+        const size_t size = mid - from;
+        for (size_t i = 0; i < size; i++)
+            buffer[i] = *_CTL_SORT_AT(from + i);
+        size_t i = 0;
+        size_t j = mid;
+        size_t k = from;
+        while (i < size && j < to)
+        {
+            // equal left ones first
+            if (_CTL_SORT_LESS(_CTL_SORT_AT(j), &buffer[i]))
+                *_CTL_SORT_AT(k++) = *_CTL_SORT_AT(j++);
+            else
+                *_CTL_SORT_AT(k++) = buffer[i++];
+        }
+        while (i < size)
+            *_CTL_SORT_AT(k++) = buffer[i++];
+    }
+    else
+    {
+        size_t i = to - mid;
+        for (size_t n = 0; n < i; n++)
+            buffer[n] = *_CTL_SORT_AT(mid + n);
+        size_t j = mid;
+        size_t k = to;
+        while (i > 0 && j > from)
+        {
+            // equal right ones last
+            if (_CTL_SORT_LESS(&buffer[i - 1], _CTL_SORT_AT(j - 1)))
+                *_CTL_SORT_AT(--k) = *_CTL_SORT_AT(--j);
+            else
+                *_CTL_SORT_AT(--k) = buffer[--i];
+        }
+        while (i > 0)
+            *_CTL_SORT_AT(--k) = buffer[--i];
+    }
+}
+
+// Bottom-up merge sort, excluding to. Sorted runs are merged in linear time.
+// Without memory for the buffer of size / 2 it is an insertion sort.
+static inline void JOIN(A, _stable_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
+{
+    if (to - from < 2)
+        return;
+    const size_t size = to - from;
+    for (size_t i = from; i < to; i += CTL_STABLE_SORT_RUN)
+        JOIN(A, _insertion_sort)(self, i, to - i > CTL_STABLE_SORT_RUN ? i + CTL_STABLE_SORT_RUN : to, _compare);
+    if (size <= CTL_STABLE_SORT_RUN)
+        return;
+    T *buffer = (T *)malloc(size / 2 * sizeof(T));
+    if (UNLIKELY(!buffer))
+    {
+        JOIN(A, _insertion_sort)(self, from, to, _compare);
+        return;
+    }
+    for (size_t width = CTL_STABLE_SORT_RUN; width < size; width *= 2)
+        for (size_t lo = from; lo < to && to - lo > width; lo += 2 * width)
+            JOIN(A, _merge)(self, lo, lo + width, to - lo > 2 * width ? lo + 2 * width : to, buffer, _compare);
+    free(buffer);
+}
+
+#if !defined CTL_DEQ && defined(POD) && !defined(NOT_INTEGRAL)
+
+#include <string.h>
+
+// above this size sort uses the radix sort for integral types
+#ifndef CTL_SORT_RADIX
+#define CTL_SORT_RADIX 1024
+#endif
+
+static inline bool JOIN(A, _radix_is_float)(void)
+{
+    return _CTL_IS_FLOAT(T);
+}
+
+// The integers, bool, float and double. Not long double, nor pointers.
+static inline bool JOIN(A, _radix_sortable)(void)
+{
+    return (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) &&
+           (!JOIN(A, _radix_is_float)() || sizeof(T) >= 4) && !_CTL_IS_POINTER(T);
+}
+
+// the unsigned key with the order of T: flip the sign bit, and all bits of
+// negative floats
+static inline uint64_t JOIN(A, _radix_key)(T *value)
+{
+    uint64_t key;
+    if (sizeof(T) == 1)
+    {
+        uint8_t k;
+        memcpy(&k, value, 1);
+        key = k;
+    }
+    else if (sizeof(T) == 2)
+    {
+        uint16_t k;
+        memcpy(&k, value, 2);
+        key = k;
+    }
+    else if (sizeof(T) == 4)
+    {
+        uint32_t k;
+        memcpy(&k, value, 4);
+        key = k;
+    }
+    else // 8 bytes. long double is not _radix_sortable, only compiled
+        memcpy(&key, value, sizeof(T) < sizeof(key) ? sizeof(T) : sizeof(key));
+    const uint64_t sign = UINT64_C(1) << (sizeof(T) <= 8 ? sizeof(T) * 8 - 1 : 63);
+    if (JOIN(A, _radix_is_float)())
+        key = key & sign ? ~key & (sign | (sign - 1)) : key ^ sign;
+    else if ((T)-1 < (T)1) // signed
+        key ^= sign;
+    return key;
+}
+
+// Ascending or descending input, which the pdqsort does in linear time.
+// Stops at the first unsorted pair of each direction.
+static inline bool JOIN(A, _radix_presorted)(T *vector, size_t size)
+{
+    size_t i = 1;
+    while (i < size && !(vector[i] < vector[i - 1]))
+        i++;
+    if (i == size)
+        return true;
+    i = 1;
+    while (i < size && !(vector[i - 1] < vector[i]))
+        i++;
+    return i == size;
+}
+
+// LSD radix sort with 11 bit digits, 8 bit for the small types. Digits equal
+// in all elements are skipped. Returns false when T is not sortable or out of
+// memory.
+static inline bool JOIN(A, _radix_sort)(T *vector, size_t size)
+{
+    if (!JOIN(A, _radix_sortable)())
+        return false;
+    const unsigned bits = sizeof(T) <= 2 ? 8 : 11;
+    const unsigned passes = (sizeof(T) * 8 + bits - 1) / bits;
+    const size_t buckets = (size_t)1 << bits;
+    const uint64_t mask = buckets - 1;
+    size_t *counts = (size_t *)calloc(passes * buckets, sizeof(size_t));
+    T *buffer = (T *)malloc(size * sizeof(T));
+    if (UNLIKELY(!counts || !buffer))
+    {
+        free(counts);
+        free(buffer);
+        return false;
+    }
+    // all histograms in one pass
+    for (size_t i = 0; i < size; i++)
+    {
+        const uint64_t key = JOIN(A, _radix_key)(&vector[i]);
+        for (unsigned p = 0; p < passes; p++)
+            counts[p * buckets + ((key >> (p * bits)) & mask)]++;
+    }
+    T *from = vector;
+    T *to = buffer;
+    for (unsigned p = 0; p < passes; p++)
+    {
+        size_t *count = &counts[p * buckets];
+        const unsigned shift = p * bits;
+        if (count[(JOIN(A, _radix_key)(&from[0]) >> shift) & mask] == size)
+            continue;
+        size_t sum = 0;
+        for (size_t d = 0; d < buckets; d++)
+        {
+            const size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < size; i++)
+            to[count[(JOIN(A, _radix_key)(&from[i]) >> shift) & mask]++] = from[i];
+        T *tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if (from != vector)
+        memcpy(vector, from, size * sizeof(T));
+    free(buffer);
+    free(counts);
+    return true;
+}
+
+#endif
+
+#ifdef CTL_SORT_PARALLEL
+
+#include <pthread.h>
+#include <unistd.h>
+
+// below this size sort_parallel sorts serially
+#ifndef CTL_SORT_PARALLEL_MIN
+#define CTL_SORT_PARALLEL_MIN 65536
+#endif
+// the default number of threads, 0 for one per online cpu
+#ifndef CTL_SORT_THREADS
+#define CTL_SORT_THREADS 0
+#endif
+// each thread gets at least this many elements
+#define CTL_SORT_THREAD_MIN 4096
+// the bucket of each element is kept in a byte
+#define CTL_SORT_THREADS_MAX 256
+// samples per bucket to choose the splitters
+#define CTL_SORT_OVERSAMPLE 32
+
+typedef struct JOIN(A, _sort_job)
+{
+    A *self;
+    int (*compare)(T *, T *);
+    T *splitters; // threads - 1
+    T *buffer;
+    uint8_t *buckets; // of each element
+    size_t *offsets;  // [thread][bucket] counts, then the scatter offsets
+    size_t *starts;   // of each bucket, and the size
+    size_t size;
+    size_t threads;
+    size_t id;
+} JOIN(A, _sort_job);
+
+// Shell sort of the samples, which are not in a container.
+static inline void JOIN(A, _sort_samples)(T *samples, size_t size, int _compare(T *, T *))
+{
+    static const size_t gaps[] = {701, 301, 132, 57, 23, 10, 4, 1};
+    for (size_t g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++)
+    {
+        const size_t gap = gaps[g];
+        for (size_t i = gap; i < size; i++)
+        {
+            T tmp = samples[i];
+            size_t j = i;
+            for (; j >= gap && _CTL_SORT_LESS(&tmp, &samples[j - gap]); j -= gap)
+                samples[j] = samples[j - gap];
+            samples[j] = tmp;
+        }
+    }
+}
+
+// Phase 1: the bucket of each element of the thread's chunk, and the counts.
+static inline void *JOIN(A, _sort_classify)(void *arg)
+{
+    JOIN(A, _sort_job) *job = (JOIN(A, _sort_job) *)arg;
+    A *self = job->self;
+    int (*_compare)(T *, T *) = job->compare;
+    const size_t from = job->size * job->id / job->threads;
+    const size_t to = job->size * (job->id + 1) / job->threads;
+    size_t *count = &job->offsets[job->id * job->threads];
+    for (size_t i = from; i < to; i++)
+    {
+        // the number of splitters not greater than the element
+        size_t lo = 0, hi = job->threads - 1;
+        T *value = _CTL_SORT_AT(i);
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (_CTL_SORT_LESS(value, &job->splitters[mid]))
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        job->buckets[i] = (uint8_t)lo;
+        count[lo]++;
+    }
+    return NULL;
+}
+
+// Phase 2: moves the chunk to its buckets in the buffer.
+static inline void *JOIN(A, _sort_scatter)(void *arg)
+{
+    JOIN(A, _sort_job) *job = (JOIN(A, _sort_job) *)arg;
+    A *self = job->self;
+    const size_t from = job->size * job->id / job->threads;
+    const size_t to = job->size * (job->id + 1) / job->threads;
+    size_t *offset = &job->offsets[job->id * job->threads];
+    for (size_t i = from; i < to; i++)
+        job->buffer[offset[job->buckets[i]]++] = *_CTL_SORT_AT(i);
+    return NULL;
+}
+
+// Phase 3: moves the thread's bucket back, at its final place, and sorts it.
+static inline void *JOIN(A, _sort_bucket)(void *arg)
+{
+    JOIN(A, _sort_job) *job = (JOIN(A, _sort_job) *)arg;
+    A *self = job->self;
+    const size_t from = job->starts[job->id];
+    const size_t to = job->starts[job->id + 1];
+    for (size_t i = from; i < to; i++)
+        *_CTL_SORT_AT(i) = job->buffer[i];
+    if (to - from < 2)
+        return NULL;
+#if !defined CTL_DEQ && defined(POD) && !defined(NOT_INTEGRAL) && !defined(COMPARE)
+    if (to - from > CTL_SORT_RADIX && job->compare == _JOIN(A, _default_integral_compare) &&
+        !JOIN(A, _radix_presorted)(_CTL_SORT_AT(from), to - from) &&
+        JOIN(A, _radix_sort)(_CTL_SORT_AT(from), to - from))
+        return NULL;
+#endif
+    JOIN(A, _ranged_sort)(self, from, to - 1, job->compare);
+    return NULL;
+}
+
+// Runs fn on all jobs, the first in the caller, and the jobs without a thread
+// also.
+static inline void JOIN(A, _sort_run)(void *(*fn)(void *), JOIN(A, _sort_job) *jobs, pthread_t *tids,
+                                      size_t threads)
+{
+    size_t started = 0;
+    for (size_t t = 1; t < threads; t++)
+        if (pthread_create(&tids[started], NULL, fn, &jobs[t]) == 0)
+            started++;
+        else
+            fn(&jobs[t]);
+    fn(&jobs[0]);
+    for (size_t t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+}
+
+// Sample sort of [0, size) with threads buckets: splitters from a sorted
+// sample, the elements are classified and scattered to their buckets in a
+// buffer in parallel, and each bucket is moved back and sorted by its own
+// thread. Not stable. Returns false when it is not worth it, or out of
+// memory.
+static inline bool JOIN(A, _sort_parallel)(A *self, size_t size, int _compare(T *, T *), size_t threads)
+{
+    if (!threads)
+        threads = CTL_SORT_THREADS;
+    if (!threads)
+    {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (threads > CTL_SORT_THREADS_MAX)
+        threads = CTL_SORT_THREADS_MAX;
+    if (threads > size / CTL_SORT_THREAD_MIN)
+        threads = size / CTL_SORT_THREAD_MIN;
+    if (size < CTL_SORT_PARALLEL_MIN || threads < 2)
+        return false;
+    const size_t samples = threads * CTL_SORT_OVERSAMPLE;
+    T *buffer = (T *)malloc(size * sizeof(T));
+    uint8_t *buckets = (uint8_t *)malloc(size);
+    size_t *offsets = (size_t *)calloc(threads * threads + threads + 1, sizeof(size_t));
+    JOIN(A, _sort_job) *jobs = (JOIN(A, _sort_job) *)malloc(threads * sizeof(JOIN(A, _sort_job)));
+    pthread_t *tids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    if (UNLIKELY(!buffer || !buckets || !offsets || !jobs || !tids))
+    {
+        free(buffer);
+        free(buckets);
+        free(offsets);
+        free(jobs);
+        free(tids);
+        return false;
+    }
+    // the samples and splitters borrow the start of the buffer, which is
+    // only scattered to after the classification
+    uint64_t rng = size;
+    for (size_t i = 0; i < samples; i++)
+    {
+        // xorshift64, rand() is not thread-safe and has the user's seed
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        buffer[i] = *_CTL_SORT_AT(rng % size);
+    }
+    JOIN(A, _sort_samples)(buffer, samples, _compare);
+    T *splitters = &buffer[samples];
+    for (size_t b = 0; b < threads - 1; b++)
+        splitters[b] = buffer[(b + 1) * CTL_SORT_OVERSAMPLE];
+    size_t *starts = &offsets[threads * threads];
+    for (size_t t = 0; t < threads; t++)
+    {
+        JOIN(A, _sort_job) job = {self, _compare, splitters, buffer, buckets, offsets, starts, size, threads, t};
+        jobs[t] = job;
+    }
+    JOIN(A, _sort_run)(JOIN(A, _sort_classify), jobs, tids, threads);
+    // the counts to offsets, by bucket and then by thread
+    size_t sum = 0;
+    for (size_t b = 0; b < threads; b++)
+    {
+        starts[b] = sum;
+        for (size_t t = 0; t < threads; t++)
+        {
+            const size_t count = offsets[t * threads + b];
+            offsets[t * threads + b] = sum;
+            sum += count;
+        }
+    }
+    starts[threads] = sum;
+    JOIN(A, _sort_run)(JOIN(A, _sort_scatter), jobs, tids, threads);
+    JOIN(A, _sort_run)(JOIN(A, _sort_bucket), jobs, tids, threads);
+    free(tids);
+    free(jobs);
+    free(offsets);
+    free(buckets);
+    free(buffer);
+    return true;
+}
+
+#endif
+
+#undef _CTL_SORT_AT
+#undef _CTL_SORT_SWAP
+#undef _CTL_SORT_LESS
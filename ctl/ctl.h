@@ -8,6 +8,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+// The max_size of the containers in bytes, 2^32 by default to avoid DDOS
+// attacks with overlarge allocations. Define it larger for huge containers.
+#ifndef CTL_MAX_SIZE
+#define CTL_MAX_SIZE UINT64_C(4294967296)
+#endif
+
 #define CAT(a, b) a##b
 #define PASTE(a, b) CAT(a, b)
 #define JOIN(prefix, name) PASTE(prefix, PASTE(_, name))
@@ -45,12 +51,28 @@
 #endif
 #define CTL_ASSERT_COMPARE ASSERT(self->compare || !"compare undefined");
 
+// Compile-time kinds of a POD T, which also compile for pointers, unlike
+// (T)1.5 != (T)1
+#if defined __GNUC__ || defined __clang__
+#define _CTL_IS_FLOAT(T) (__builtin_classify_type((T)0) == 8)
+#define _CTL_IS_POINTER(T) (__builtin_classify_type((T)0) == 5)
+#elif defined __cplusplus
+#include <type_traits>
+#define _CTL_IS_FLOAT(T) (std::is_floating_point<T>::value)
+#define _CTL_IS_POINTER(T) (std::is_pointer<T>::value)
+#else
+#define _CTL_IS_FLOAT(T) _Generic((T)0, float: 1, double: 1, long double: 1, default: 0)
+#define _CTL_IS_POINTER(T) 0 // best effort without a portable C test
+#endif
+
 #if __GNUC__ >= 3 && !defined _WIN32
 #define LIKELY(x) __builtin_expect((long)(x) != 0, 1)
 #define UNLIKELY(x) __builtin_expect((long)(x) != 0, 0)
+#define PREFETCH(x) __builtin_prefetch(x)
 #else
 #define LIKELY(x) x
 #define UNLIKELY(x) x
+#define PREFETCH(x)
 #endif
 #endif
 
@@ -15,6 +15,7 @@
 #define GI JOIN(A, it)
 
 #include <ctl/ctl.h>
+#include <ctl/bits/alloc.h>
 
 #ifndef DEQ_BUCKET_SIZE
 #define DEQ_BUCKET_SIZE (512)
@@ -68,10 +69,10 @@ static inline T *JOIN(A, at)(A *self, size_t index)
     {
         ASSERT(index <= self->size || !"invalid deque index");
         self->capacity = 1;
-        self->pages = (B **)calloc(1, sizeof(B *));
+        self->pages = (B **)_CTL_CALLOC(1, sizeof(B *));
         if (!self->pages)
             return NULL;
-        self->pages[0] = (B *)calloc(1, sizeof(B));
+        self->pages[0] = (B *)_CTL_CALLOC(1, sizeof(B));
         if (!self->pages[0])
             return NULL;
         return &self->pages[0]->value[0];
@@ -254,7 +255,7 @@ static inline I JOIN(B, iter)(A *self, size_t index)
 
 static inline B *JOIN(B, init)(size_t cut)
 {
-    B *self = (B *)malloc(sizeof(B));
+    B *self = (B *)CTL_ALLOC(sizeof(B));
     self->a = self->b = cut;
     return self;
 }
@@ -277,7 +278,7 @@ static inline void JOIN(A, set)(A *self, size_t index, T value)
 static inline void JOIN(A, alloc)(A *self, size_t capacity, size_t shift_from)
 {
     self->capacity = capacity;
-    self->pages = (B **)realloc(self->pages, capacity * sizeof(B *));
+    self->pages = (B **)CTL_REALLOC(self->pages, capacity * sizeof(B *));
     size_t shift = (self->capacity - shift_from) / 2;
     size_t i = self->mark_b;
     while (i != 0)
@@ -343,7 +344,7 @@ static inline void JOIN(A, pop_front)(A *self)
     self->size--;
     if (page->a == page->b)
     {
-        free(page);
+        CTL_FREE(page);
         self->mark_a++;
     }
 }
@@ -388,7 +389,7 @@ static inline void JOIN(A, pop_back)(A *self)
 #endif
     if (page->b == page->a)
     {
-        free(page);
+        CTL_FREE(page);
         self->mark_b--;
     }
 }
@@ -481,7 +482,7 @@ static inline void JOIN(A, clear)(A *self)
 static inline void JOIN(A, free)(A *self)
 {
     JOIN(A, clear)(self);
-    free(self->pages);
+    CTL_FREE(self->pages);
     *self = JOIN(A, init)();
 }
 
@@ -628,37 +629,11 @@ static inline void JOIN(A, assign_generic)(A *self, GI *range)
             JOIN(A, pop_back)(self);
 }
 
-// including to
-static inline void JOIN(A, _ranged_sort)(A *self, size_t from, size_t to, int _compare(T *, T *))
-{
-    if (UNLIKELY(from >= to))
-        return;
-    // TODO insertion_sort cutoff
-    // long mid = (from + to) / 2; // overflow!
-    // Dietz formula http://aggregate.org/MAGIC/#Average%20of%20Integers
-    size_t mid = ((from ^ to) >> 1) + (from & to);
-    SWAP(T, JOIN(A, at)(self, from), JOIN(A, at)(self, mid));
-    size_t z = from;
-    // check overflow of a + 1
-    if (LIKELY(from + 1 > from))
-        for (size_t i = from + 1; i <= to; i++)
-            if (!_compare(JOIN(A, at)(self, from), JOIN(A, at)(self, i)))
-            {
-                z++;
-                SWAP(T, JOIN(A, at)(self, z), JOIN(A, at)(self, i));
-            }
-    SWAP(T, JOIN(A, at)(self, from), JOIN(A, at)(self, z));
-    if (LIKELY(z))
-        JOIN(A, _ranged_sort)(self, from, z - 1, _compare);
-    // check overflow of z + 1
-    if (LIKELY(z + 1 > z))
-        JOIN(A, _ranged_sort)(self, z + 1, to, _compare);
-}
+#include <ctl/bits/sort.h>
 
 static inline void JOIN(A, sort)(A *self)
 {
     CTL_ASSERT_COMPARE
-    // TODO insertion_sort cutoff
     if (self->size > 1)
         JOIN(A, _ranged_sort)(self, 0, self->size - 1, self->compare);
 }
@@ -667,11 +642,34 @@ static inline void JOIN(A, sort)(A *self)
 static inline void JOIN(A, sort_range)(A *self, size_t from, size_t to)
 {
     CTL_ASSERT_COMPARE
-    // TODO insertion_sort cutoff
     if (to > 1) // overflow with 0
         JOIN(A, _ranged_sort)(self, from, to - 1, self->compare);
 }
 
+static inline void JOIN(A, stable_sort)(A *self)
+{
+    CTL_ASSERT_COMPARE
+    JOIN(A, _stable_sort)(self, 0, self->size, self->compare);
+}
+
+static inline void JOIN(A, stable_sort_range)(I *range)
+{
+    A *self = range->container;
+    CTL_ASSERT_COMPARE
+    JOIN(A, _stable_sort)(self, range->index, range->end, self->compare);
+}
+
+#ifdef CTL_SORT_PARALLEL
+// Sorts with threads threads, 0 for CTL_SORT_THREADS or one per cpu. Small
+// deques are sorted serially.
+static inline void JOIN(A, sort_parallel)(A *self, size_t threads)
+{
+    CTL_ASSERT_COMPARE
+    if (!JOIN(A, _sort_parallel)(self, self->size, self->compare, threads))
+        JOIN(A, sort)(self);
+}
+#endif
+
 static inline size_t JOIN(A, remove_if)(A *self, int (*_match)(T *))
 {
     if (!self->size)
@@ -748,6 +746,13 @@ static inline void JOIN(A, insert_generic)(I *pos, GI *range)
 #undef I
 #undef GI
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef NOT_INTEGRAL
 #undef CTL_DEQ
 
@@ -1161,6 +1161,8 @@ static inline void JOIN(A, shuffle)(A *self)
 }
 
 #undef POD
+#undef COMPARE
+#undef EQUAL
 #undef NOT_INTEGRAL
 #undef T
 #undef A
@@ -0,0 +1,834 @@
+/* Open-addressing hashtable with linear robin-hood probing and backward-shift
+   deletion, for small keys such as integers (the "stanford hash").
+   SPDX-License-Identifier: MIT
+
+   Same API as unordered_set, but the values are stored inline in one flat
+   slot array, with one byte per slot for the probe distance. No node
+   allocations, no tombstones, and iteration is a linear scan over the
+   distance bytes.
+   As with every open-addressing table, pointers and iterators into the table
+   are invalidated by inserts (rehashes) and erase.
+
+   An insert takes the slot of the first element closer to its home slot than
+   the new one (robin-hood), which is then carried forward. This keeps the
+   variance of the probe lengths low, and a lookup stops at the first slot
+   with a shorter distance than its own. Erase shifts the following displaced
+   elements back by one slot.
+
+   The table is not wrapped around: behind the last home slot there are
+   min(capacity, CTL_HMAP_MAX_DIST) overflow slots, plus 8 empty distance
+   bytes as sentinel and for the word-at-a-time scans.
+   When a probe distance would pass CTL_HMAP_MAX_DIST (255), the table
+   doubles. If that happens in a nearly empty table, the hash function is
+   degenerate (or under attack), and CTL_HMAP_SECURITY_ACTION is called,
+   abort() by default. It must not return.
+
+  CTL_HMAP_MAX_LOAD_FACTOR defaults to 0.5. Linear probing inserts get
+  expensive at higher loads, but finds stay fast up to about 0.8.
+*/
+
+#ifndef T
+#error "Template type T undefined for <ctl/hashmap.h>"
+#endif
+
+#include <ctl/ctl.h>
+#include <ctl/bits/hash.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef CTL_HMAP_MAX_LOAD_FACTOR
+#define CTL_HMAP_MAX_LOAD_FACTOR 0.5f
+#endif
+#ifndef CTL_HMAP_MAX_DIST
+#define CTL_HMAP_MAX_DIST 255
+#endif
+#ifndef CTL_HMAP_SECURITY_ACTION
+#define CTL_HMAP_SECURITY_ACTION abort()
+#endif
+// the smallest table, a power of 2
+#define CTL_HMAP_MIN_SIZE 8
+
+#ifndef __CTL_HASHMAP_SCAN__
+#define __CTL_HASHMAP_SCAN__
+
+// the 0x80 bit set for each full slot of the 8 distance bytes at p, first
+// slot in the lowest byte
+static inline uint64_t _ctl_hmap_match_full(const uint8_t *p)
+{
+    const uint64_t lo7 = UINT64_C(0x7f7f7f7f7f7f7f7f);
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return (((w & lo7) + lo7) | w) & ~lo7;
+}
+
+// the slot of the lowest byte with a match
+static inline unsigned _ctl_hmap_first(uint64_t m)
+{
+#ifdef __GNUC__
+    return (unsigned)__builtin_ctzll(m) >> 3;
+#else
+    unsigned n = 0;
+    while (!(m & 0x80))
+    {
+        m >>= 8;
+        n++;
+    }
+    return n;
+#endif
+}
+
+#endif // __CTL_HASHMAP_SCAN__
+
+// share the uset policies in ctl/bits and algorithm.h
+#define CTL_USET
+#define CTL_HMAP
+#define A JOIN(hmap, T)
+#define I JOIN(A, it)
+#define GI JOIN(A, it)
+
+typedef struct A
+{
+    uint8_t *dist; // per slot: 0 empty, else the probe distance + 1. Plus 8 zeros
+    T *slots;
+    size_t size;
+    size_t bucket_max; // index of the last home slot. capacity - 1, power of 2
+    size_t growth_limit;
+    float max_load_factor;
+    void (*free)(T *);
+    T (*copy)(T *);
+    size_t (*hash)(T *);
+    int (*equal)(T *, T *);
+} A;
+
+#include <ctl/bits/iterator_vtable.h>
+
+typedef struct I
+{
+    CTL_HMAP_ITER_FIELDS;
+} I;
+
+#include <ctl/bits/iterators.h>
+
+static inline size_t JOIN(A, bucket_count)(A *self)
+{
+    return self->dist ? self->bucket_max + 1 : 0;
+}
+
+// the overflow slots behind the home slots
+static inline size_t JOIN(A, _tail)(size_t cap)
+{
+    return cap < CTL_HMAP_MAX_DIST ? cap : CTL_HMAP_MAX_DIST;
+}
+
+// all slots, home and overflow. The index of the first sentinel.
+static inline size_t JOIN(A, _slot_count)(A *self)
+{
+    if (!self->dist)
+        return 0;
+    return self->bucket_max + 1 + JOIN(A, _tail)(self->bucket_max + 1);
+}
+
+// The user hash is often the identity for integers. Mix it for the mask.
+static inline size_t JOIN(A, _hash)(A *self, T *value)
+{
+    return ctl_hash_int((uint64_t)self->hash(value));
+}
+
+// index of the next full slot at or after i, or the slot count.
+// 8 slots at once, without a branch per slot.
+static inline size_t JOIN(A, _next_full)(A *self, size_t i)
+{
+    const size_t end = JOIN(A, _slot_count)(self);
+    while (i < end)
+    {
+        const uint64_t m = _ctl_hmap_match_full(&self->dist[i]);
+        if (m)
+        {
+            i += _ctl_hmap_first(m);
+            return i < end ? i : end;
+        }
+        i += 8;
+    }
+    return end;
+}
+
+static inline I JOIN(I, iter)(A *self, size_t index);
+static inline I JOIN(A, begin)(A *self);
+static inline I JOIN(A, end)(A *self);
+
+static inline T *JOIN(I, ref)(I *iter)
+{
+    return iter->ref;
+}
+
+// We don't support hmap ranges
+static inline int JOIN(I, done)(I *iter)
+{
+    return iter->ref == NULL;
+}
+
+static inline void JOIN(I, next)(I *iter)
+{
+    A *self = iter->container;
+    ASSERT(iter->ref);
+    iter->index = JOIN(A, _next_full)(self, iter->index + 1);
+    iter->ref = iter->index < JOIN(A, _slot_count)(self) ? &self->slots[iter->index] : NULL;
+}
+
+static inline I *JOIN(I, advance)(I *iter, long i)
+{
+    if (i < 0)
+    {
+        i = iter->container->size + i;
+        I it = JOIN(A, begin)(iter->container);
+        iter->index = it.index;
+        iter->ref = it.ref;
+    }
+    for (long j = 0; j < i && iter->ref; j++)
+        JOIN(I, next)(iter);
+    return iter;
+}
+
+// advance end only (*_n algos)
+static inline void JOIN(I, advance_end)(I *iter, long n)
+{
+    (void)iter; // ignore ranges
+    (void)n;    // ignore ranges
+}
+
+// no ranges, ignore last iters
+static inline void JOIN(I, range)(I *begin, I *end)
+{
+    (void)begin;
+    (void)end;
+}
+
+static inline void JOIN(I, set_end)(I *iter, I *last)
+{
+    (void)iter; // ignore ranges
+    (void)last; // ignore ranges
+}
+
+static inline void JOIN(I, set_pos)(I *iter, I *other)
+{
+    iter->index = other->index;
+    iter->ref = other->ref;
+}
+
+static inline void JOIN(I, set_done)(I *iter)
+{
+    iter->ref = NULL;
+}
+
+// ignore
+static inline void JOIN(I, prev)(I *iter)
+{
+    (void)iter;
+}
+
+static inline int JOIN(A, _equal)(A *self, T *a, T *b)
+{
+    ASSERT(self->equal || !"equal undefined");
+    return self->equal(a, b);
+}
+
+static inline A JOIN(A, init_from)(A *copy);
+static inline A JOIN(A, copy)(A *self);
+static inline void JOIN(A, insert)(A *self, T value);
+
+static inline void JOIN(A, inserter)(A *self, T value)
+{
+    JOIN(A, insert)(self, value);
+}
+
+#include <ctl/bits/container.h>
+
+static inline I JOIN(A, end)(A *self)
+{
+    static I zero;
+    I iter = zero;
+    iter.container = self;
+    iter.index = JOIN(A, _slot_count)(self);
+    iter.vtable.next = JOIN(I, next);
+    iter.vtable.ref = JOIN(I, ref);
+    iter.vtable.done = JOIN(I, done);
+    return iter;
+}
+
+static inline I JOIN(I, iter)(A *self, size_t index)
+{
+    I iter = JOIN(A, end)(self);
+    if (index < JOIN(A, _slot_count)(self))
+    {
+        iter.index = index;
+        iter.ref = &self->slots[index];
+    }
+    return iter;
+}
+
+static inline I JOIN(A, begin)(A *self)
+{
+    if (!self->size)
+        return JOIN(A, end)(self);
+    return JOIN(I, iter)(self, JOIN(A, _next_full)(self, 0));
+}
+
+static inline void JOIN(A, max_load_factor)(A *self, float f)
+{
+    self->max_load_factor = f;
+    if (self->dist)
+        self->growth_limit = (size_t)((self->bucket_max + 1) * f);
+}
+
+static inline float JOIN(A, load_factor)(A *self)
+{
+    return self->dist ? (float)self->size / (float)(self->bucket_max + 1) : 0.0f;
+}
+
+static inline size_t JOIN(A, __next_power2)(size_t n)
+{
+    size_t p = CTL_HMAP_MIN_SIZE;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+// the capacity needed for n elements
+static inline size_t JOIN(A, _capacity_for)(A *self, size_t n)
+{
+    return JOIN(A, __next_power2)((size_t)((double)n / self->max_load_factor) + 1);
+}
+
+// Robin-hood placement of a new element, from slot i at probe distance d
+// (its home and 1, or where a lookup stopped): it takes the slot of the first
+// element with a shorter probe distance, which is then carried forward.
+// Sets pos to the slot of the first placement, the original value.
+// Returns false if a probe distance overflowed, with the now homeless
+// element left in value.
+static inline bool JOIN(A, _place)(A *self, T *value, size_t i, unsigned d, size_t *pos)
+{
+    const size_t end = JOIN(A, _slot_count)(self);
+    *pos = SIZE_MAX;
+    for (;;)
+    {
+        if (d > CTL_HMAP_MAX_DIST || i == end)
+            return false;
+        if (!self->dist[i])
+            break;
+        if (self->dist[i] < d)
+        {
+            const T tmp = self->slots[i];
+            const unsigned dt = self->dist[i];
+            self->slots[i] = *value;
+            self->dist[i] = (uint8_t)d;
+            *value = tmp;
+            d = dt;
+            if (*pos == SIZE_MAX)
+                *pos = i;
+        }
+        i++;
+        d++;
+    }
+    self->slots[i] = *value;
+    self->dist[i] = (uint8_t)d;
+    if (*pos == SIZE_MAX)
+        *pos = i;
+    return true;
+}
+
+// new_size must be a power of 2. Doubles further on an overflow.
+static inline void JOIN(A, _resize)(A *self, size_t new_size)
+{
+    A old = *self;
+    ASSERT(new_size >= CTL_HMAP_MIN_SIZE && (new_size & (new_size - 1)) == 0);
+    for (;;)
+    {
+        const size_t slots = new_size + JOIN(A, _tail)(new_size);
+        bool ok = true;
+        self->dist = (uint8_t *)calloc(slots + 8, 1);
+        self->slots = (T *)malloc(slots * sizeof(T));
+        ASSERT(self->dist && self->slots && "out of memory");
+        self->bucket_max = new_size - 1;
+        if (old.dist && old.size)
+            for (size_t i = JOIN(A, _next_full)(&old, 0); i < JOIN(A, _slot_count)(&old);
+                 i = JOIN(A, _next_full)(&old, i + 1))
+            {
+                T value = old.slots[i];
+                size_t pos;
+                if (!JOIN(A, _place)(self, &value, JOIN(A, _hash)(self, &value) & self->bucket_max, 1, &pos))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+        if (ok)
+            break;
+        // the old table is still intact
+        free(self->dist);
+        free(self->slots);
+        if (old.size < new_size / 8)
+            CTL_HMAP_SECURITY_ACTION;
+        new_size *= 2;
+    }
+    JOIN(A, max_load_factor)(self, self->max_load_factor);
+    if (self->growth_limit >= new_size)
+        self->growth_limit = new_size - 1;
+    if (old.dist)
+    {
+        free(old.dist);
+        free(old.slots);
+    }
+}
+
+static inline void JOIN(A, reserve)(A *self, size_t desired_count)
+{
+    if (desired_count == 0 || desired_count > JOIN(A, max_size)())
+        return;
+    const size_t new_size = JOIN(A, _capacity_for)(self, desired_count);
+    if (new_size > JOIN(A, bucket_count)(self))
+        JOIN(A, _resize)(self, new_size);
+}
+
+// we do allow shrink here, but not below the size
+static inline void JOIN(A, rehash)(A *self, size_t desired_count)
+{
+    size_t new_size = JOIN(A, __next_power2)(desired_count);
+    const size_t min_size = JOIN(A, _capacity_for)(self, self->size);
+    if (new_size < min_size)
+        new_size = min_size;
+    if (new_size == JOIN(A, bucket_count)(self))
+        return;
+    JOIN(A, _resize)(self, new_size);
+}
+
+static inline A JOIN(A, init)(size_t (*_hash)(T *), int (*_equal)(T *, T *))
+{
+    static A zero;
+    A self = zero;
+    self.hash = _hash;
+    self.equal = _equal;
+#ifdef POD
+    self.copy = JOIN(A, implicit_copy);
+    _JOIN(A, _set_default_methods)(&self);
+#else
+    self.free = JOIN(T, free);
+    self.copy = JOIN(T, copy);
+#endif
+    self.max_load_factor = CTL_HMAP_MAX_LOAD_FACTOR;
+    // the tables are allocated lazily, on the first insert
+    return self;
+}
+
+static inline A JOIN(A, init_from)(A *copy)
+{
+    static A zero;
+    A self = zero;
+#ifdef POD
+    self.copy = JOIN(A, implicit_copy);
+#else
+    self.free = JOIN(T, free);
+    self.copy = JOIN(T, copy);
+#endif
+    self.hash = copy->hash;
+    self.equal = copy->equal;
+    self.max_load_factor = copy->max_load_factor;
+    return self;
+}
+
+// Note: As this is used internally a lot, don't consume (free) the key.
+// Returns the slot index, or SIZE_MAX if not found.
+static inline size_t JOIN(A, _find_hash)(A *self, T *value, size_t hash)
+{
+    size_t i = hash & self->bucket_max;
+    // stops at an empty slot, or at an element closer to its home than we
+    // would be. Only elements with the same home are compared.
+    for (unsigned d = 1; d <= self->dist[i]; d++, i++)
+        if (self->dist[i] == d && self->equal(value, &self->slots[i]))
+            return i;
+    return SIZE_MAX;
+}
+
+static inline size_t JOIN(A, _find_index)(A *self, T *value)
+{
+    if (!self->size)
+        return SIZE_MAX;
+    return JOIN(A, _find_hash)(self, value, JOIN(A, _hash)(self, value));
+}
+
+static inline T *JOIN(A, find_ref)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    return i == SIZE_MAX ? NULL : &self->slots[i];
+}
+
+static inline I JOIN(A, find)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    if (i == SIZE_MAX)
+        return JOIN(A, end)(self);
+    return JOIN(I, iter)(self, i);
+}
+
+static inline void JOIN(A, _pre_insert_grow)(A *self)
+{
+    if (!self->dist)
+        JOIN(A, _resize)(self, CTL_HMAP_MIN_SIZE);
+    else if (self->size + 1 > self->growth_limit)
+        JOIN(A, _resize)(self, (self->bucket_max + 1) * 2);
+}
+
+// A probe distance overflowed. Doubling helps, unless the table is still
+// nearly empty and all the hashes collide.
+static inline void JOIN(A, _grow_overflow)(A *self)
+{
+    const size_t cap = self->bucket_max + 1;
+    if (self->size < cap / 8)
+        CTL_HMAP_SECURITY_ACTION;
+    JOIN(A, _resize)(self, cap * 2);
+}
+
+// value must not exist yet, and the lookup of it stopped at slot i with
+// probe distance d. Returns its slot.
+static inline size_t JOIN(A, _insert_at)(A *self, T *value, size_t hash, size_t i, unsigned d)
+{
+    T carry = *value;
+    size_t pos;
+    bool placed = false;
+    if (!self->dist || self->size + 1 > self->growth_limit)
+    {
+        JOIN(A, _pre_insert_grow)(self);
+        i = hash & self->bucket_max;
+        d = 1;
+    }
+    if (JOIN(A, _place)(self, &carry, i, d, &pos))
+    {
+        self->size++;
+        return pos;
+    }
+    // grow and place the homeless element, which is value until it was placed
+    do
+    {
+        placed |= pos != SIZE_MAX;
+        JOIN(A, _grow_overflow)(self);
+    } while (!JOIN(A, _place)(self, &carry, JOIN(A, _hash)(self, &carry) & self->bucket_max, 1, &pos));
+    self->size++;
+    if (placed)
+        return JOIN(A, _find_hash)(self, value, hash);
+    return pos;
+}
+
+static inline I JOIN(A, emplace_found)(A *self, T *value, int *foundp)
+{
+    const size_t hash = JOIN(A, _hash)(self, value);
+    size_t i = hash & self->bucket_max;
+    unsigned d = 1;
+    // as _find_hash, but the insert continues where the lookup stopped
+    if (self->dist)
+        for (; d <= self->dist[i]; d++, i++)
+            if (self->dist[i] == d && self->equal(value, &self->slots[i]))
+            {
+                FREE_VALUE(self, *value);
+                *foundp = 1;
+                return JOIN(I, iter)(self, i);
+            }
+    *foundp = 0;
+    return JOIN(I, iter)(self, JOIN(A, _insert_at)(self, value, hash, i, d));
+}
+
+static inline I JOIN(A, emplace)(A *self, T *value)
+{
+    int found;
+    return JOIN(A, emplace_found)(self, value, &found);
+}
+
+// the position makes no sense with open addressing
+static inline I JOIN(A, emplace_hint)(I *pos, T *value)
+{
+    return JOIN(A, emplace)(pos->container, value);
+}
+
+static inline I JOIN(A, insert_found)(A *self, T value, int *foundp)
+{
+    return JOIN(A, emplace_found)(self, &value, foundp);
+}
+
+static inline void JOIN(A, insert)(A *self, T value)
+{
+    int found;
+    JOIN(A, emplace_found)(self, &value, &found);
+}
+
+static inline size_t JOIN(A, count)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    FREE_VALUE(self, value);
+    return i == SIZE_MAX ? 0UL : 1UL;
+}
+
+// C++20
+static inline bool JOIN(A, contains)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    FREE_VALUE(self, value);
+    return i != SIZE_MAX;
+}
+
+// backward-shift deletion: the following displaced elements move one slot
+// closer to their home, up to an empty slot or an element at its home.
+static inline void JOIN(A, _erase_index)(A *self, size_t i)
+{
+#ifndef POD
+    if (self->free)
+        self->free(&self->slots[i]);
+#endif
+    // stops at the sentinel
+    while (self->dist[i + 1] > 1)
+    {
+        self->slots[i] = self->slots[i + 1];
+        self->dist[i] = self->dist[i + 1] - 1;
+        i++;
+    }
+    self->dist[i] = 0;
+    self->size--;
+}
+
+static inline void JOIN(A, erase)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    if (i != SIZE_MAX)
+        JOIN(A, _erase_index)(self, i);
+}
+
+// advances pos to the next element, which might have been shifted into pos
+static inline void JOIN(A, erase_it)(I *pos)
+{
+    if (!JOIN(I, done)(pos))
+    {
+        A *self = pos->container;
+        JOIN(A, _erase_index)(self, pos->index);
+        if (!self->dist[pos->index])
+            JOIN(I, next)(pos);
+    }
+}
+
+static inline size_t JOIN(A, erase_if)(A *self, int (*_match)(T *))
+{
+    size_t erases = 0;
+    if (!self->size)
+        return 0;
+    const size_t end = JOIN(A, _slot_count)(self);
+    // after an erase, check the shifted element at i again
+    for (size_t i = JOIN(A, _next_full)(self, 0); i < end;)
+    {
+        if (self->dist[i] && _match(&self->slots[i]))
+        {
+            JOIN(A, _erase_index)(self, i);
+            erases += 1;
+        }
+        else
+            i = JOIN(A, _next_full)(self, i + 1);
+    }
+    return erases;
+}
+
+static inline void JOIN(A, clear)(A *self)
+{
+    if (LIKELY(self->dist))
+    {
+#ifndef POD
+        if (self->free && self->size)
+            for (size_t i = JOIN(A, _next_full)(self, 0); i < JOIN(A, _slot_count)(self);
+                 i = JOIN(A, _next_full)(self, i + 1))
+                self->free(&self->slots[i]);
+#endif
+        memset(self->dist, 0, JOIN(A, _slot_count)(self));
+    }
+    self->size = 0;
+}
+
+static inline void JOIN(A, free)(A *self)
+{
+    JOIN(A, clear)(self);
+    free(self->dist);
+    free(self->slots);
+    self->dist = NULL;
+    self->slots = NULL;
+    self->bucket_max = 0;
+    self->growth_limit = 0;
+}
+
+// Same hash, same layout. No need to rehash.
+static inline A JOIN(A, copy)(A *self)
+{
+    A other = JOIN(A, init_from)(self);
+    if (!self->dist)
+        return other;
+    const size_t slots = JOIN(A, _slot_count)(self);
+    other.dist = (uint8_t *)malloc(slots + 8);
+    other.slots = (T *)malloc(slots * sizeof(T));
+    ASSERT(other.dist && other.slots && "out of memory");
+    memcpy(other.dist, self->dist, slots + 8);
+#ifdef POD
+    memcpy(other.slots, self->slots, slots * sizeof(T));
+#else
+    if (self->size)
+        for (size_t i = JOIN(A, _next_full)(self, 0); i < slots; i = JOIN(A, _next_full)(self, i + 1))
+            other.slots[i] = self->copy(&self->slots[i]);
+#endif
+    other.size = self->size;
+    other.bucket_max = self->bucket_max;
+    other.growth_limit = self->growth_limit;
+    return other;
+}
+
+static inline void JOIN(A, insert_generic)(A *self, GI *range)
+{
+    void (*next)(struct I *) = range->vtable.next;
+    T *(*ref)(struct I *) = range->vtable.ref;
+    int (*done)(struct I *) = range->vtable.done;
+
+    while (!done(range))
+    {
+        JOIN(A, insert)(self, self->copy(ref(range)));
+        next(range);
+    }
+}
+
+static inline void JOIN(A, erase_generic)(A *self, GI *range)
+{
+    void (*next)(struct I *) = range->vtable.next;
+    T *(*ref)(struct I *) = range->vtable.ref;
+    int (*done)(struct I *) = range->vtable.done;
+
+    while (!done(range))
+    {
+        JOIN(A, erase)(self, *ref(range));
+        next(range);
+    }
+}
+
+static inline A JOIN(A, union)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    JOIN(A, reserve)(&self, a->size + b->size);
+    foreach (A, a, it1)
+        JOIN(A, insert)(&self, self.copy(it1.ref));
+    foreach (A, b, it2)
+        JOIN(A, insert)(&self, self.copy(it2.ref));
+    return self;
+}
+
+static inline A JOIN(A, intersection)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) != SIZE_MAX)
+            JOIN(A, insert)(&self, self.copy(it.ref));
+    return self;
+}
+
+static inline A JOIN(A, difference)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) == SIZE_MAX)
+            JOIN(A, insert)(&self, self.copy(it.ref));
+    return self;
+}
+
+static inline A JOIN(A, symmetric_difference)(A *a, A *b)
+{
+    A self = JOIN(A, union)(a, b);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) != SIZE_MAX)
+            JOIN(A, erase)(&self, *it.ref);
+    return self;
+}
+
+// different to the shared equal
+static inline int JOIN(A, equal)(A *self, A *other)
+{
+    if (self->size != other->size)
+        return 0;
+    foreach (A, self, it)
+        if (JOIN(A, _find_index)(other, it.ref) == SIZE_MAX)
+            return 0;
+    return 1;
+}
+
+static inline void JOIN(A, swap)(A *self, A *other)
+{
+    A temp = *self;
+    *self = *other;
+    *other = temp;
+}
+
+// i.e. insert_range
+static inline A JOIN(A, merge_range)(I *r1, GI *r2)
+{
+    A self = JOIN(A, copy)(r1->container);
+    void (*next2)(struct I *) = r2->vtable.next;
+    T *(*ref2)(struct I *) = r2->vtable.ref;
+    int (*done2)(struct I *) = r2->vtable.done;
+
+    while (!done2(r2))
+    {
+        JOIN(A, inserter)(&self, self.copy(ref2(r2)));
+        next2(r2);
+    }
+    return self;
+}
+
+static inline A JOIN(A, merge)(A *self, A *other)
+{
+    return JOIN(A, union)(self, other);
+}
+
+// This one changes in place.
+static inline void JOIN(A, generate)(A *self, T _gen(void))
+{
+    size_t size = self->size;
+    JOIN(A, clear)(self);
+    for (size_t i = 0; i < size; i++)
+        JOIN(A, inserter)(self, _gen());
+}
+
+// We shrink to n, as uset.
+static inline void JOIN(A, generate_n)(A *self, size_t n, T _gen(void))
+{
+    JOIN(A, clear)(self);
+    for (size_t i = 0; i < n; i++)
+        JOIN(A, insert)(self, _gen());
+}
+
+// non-destructive, returns a copy
+static inline A JOIN(A, transform)(A *self, T _unop(T *))
+{
+    A other = JOIN(A, init_from)(self);
+    foreach (A, self, it)
+    {
+        T copy = self->copy(it.ref);
+        T tmp = _unop(&copy);
+        JOIN(A, insert)(&other, tmp);
+        if (self->free)
+            self->free(&copy);
+    }
+    return other;
+}
+
+#undef POD
+#undef COMPARE
+#undef EQUAL
+#undef A
+#undef I
+#undef GI
+#undef T
+#undef CTL_USET
+#undef CTL_HMAP
+
+#ifdef USE_INTERNAL_VERIFY
+#undef USE_INTERNAL_VERIFY
+#endif
@@ -13,6 +13,7 @@
 #define GI JOIN(A, it)
 
 #include <ctl/ctl.h>
+#include <ctl/bits/alloc.h>
 
 typedef struct B
 {
@@ -255,7 +256,7 @@ static inline A JOIN(A, init_from)(A *copy)
 
 static inline B *JOIN(B, init)(T value)
 {
-    B *self = (B *)malloc(sizeof(B));
+    B *self = (B *)CTL_ALLOC(sizeof(B));
     self->prev = self->next = NULL;
     self->value = value;
     return self;
@@ -306,7 +307,7 @@ static inline void JOIN(A, erase_node)(A *self, B *node)
         JOIN(A, disconnect)(self, node);
     if (self->free)
         self->free(&node->value);
-    free(node);
+    CTL_FREE(node);
 }
 
 static inline void JOIN(A, erase)(I *it)
@@ -926,6 +927,13 @@ static inline void JOIN(A, verify)(A *self)
 #endif
 
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef NOT_INTEGRAL
 #undef T
 #undef A
@@ -24,7 +24,7 @@ static inline I JOIN(A, insert_or_assign)(A *self, T key)
         B *node = self->root;
         while (1)
         {
-            int diff = self->compare(&key, &node->value);
+            int diff = _CTL_COMPARE(self->compare, &key, &node->value);
             if (diff == 0)
             {
                 JOIN(A, free_node)(self, node);
@@ -72,7 +72,7 @@ static inline I JOIN(A, insert_or_assign_found)(A *self, T key, int *foundp)
         B *node = self->root;
         while (1)
         {
-            int diff = self->compare(&key, &node->value);
+            int diff = _CTL_COMPARE(self->compare, &key, &node->value);
             if (diff == 0)
             {
                 JOIN(A, free_node)(self, node);
@@ -117,6 +117,11 @@ static inline I JOIN(A, insert_or_assign_found)(A *self, T key, int *foundp)
 #undef _set
 #undef set
 #undef T
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef A
 #undef B
 #undef I
@@ -26,6 +26,8 @@
 #define insert __INSERT
 #define erase __ERASE
 #define sort __SORT
+#define stable_sort __STABLE_SORT
+#define sort_parallel __SORT_PARALLEL
 #define step __STEP
 #define range __RANGE
 #define each __EACH
@@ -54,13 +56,13 @@ static inline A JOIN(A, init)(int _compare(T *, T *))
 
 static inline void JOIN(A, up)(A *self, size_t n)
 {
-    ASSERT(self->compare || !"compare undefined");
+    CTL_ASSERT_COMPARE
     if (n > 0)
     {
         size_t p = (n - 1) / 2;
         T *x = &self->vector[n];
         T *y = &self->vector[p];
-        if (self->compare(y, x))
+        if (_CTL_COMPARE(self->compare, y, x))
         {
             SWAP(T, x, y);
             JOIN(A, up)(self, p);
@@ -70,7 +72,7 @@ static inline void JOIN(A, up)(A *self, size_t n)
 
 static inline void JOIN(A, down)(A *self, size_t n)
 {
-    ASSERT(self->compare || !"compare undefined");
+    CTL_ASSERT_COMPARE
     size_t min = 2;
     if (self->size < min)
         return;
@@ -78,7 +80,7 @@ static inline void JOIN(A, down)(A *self, size_t n)
     {
         T *a = &self->vector[0];
         T *b = &self->vector[1];
-        if (self->compare(a, b))
+        if (_CTL_COMPARE(self->compare, a, b))
             SWAP(T, a, b);
     }
     else
@@ -87,10 +89,10 @@ static inline void JOIN(A, down)(A *self, size_t n)
         size_t r = 2 * n + 2;
         if (r < self->size)
         {
-            size_t index = self->compare(&self->vector[r], &self->vector[l]) ? l : r;
+            size_t index = _CTL_COMPARE(self->compare, &self->vector[r], &self->vector[l]) ? l : r;
             T *x = &self->vector[index];
             T *y = &self->vector[n];
-            if (self->compare(y, x))
+            if (_CTL_COMPARE(self->compare, y, x))
             {
                 SWAP(T, x, y);
                 JOIN(A, down)(self, index);
@@ -140,6 +142,8 @@ static inline void JOIN(A, emplace)(A *self, T *value)
 #undef insert
 #undef erase
 #undef sort
+#undef stable_sort
+#undef sort_parallel
 #undef step
 #undef range
 #undef each
@@ -147,6 +151,13 @@ static inline void JOIN(A, emplace)(A *self, T *value)
 
 #undef T // See HOLD.
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef NOT_INTEGRAL
 #undef A
 #define CTL_PQU
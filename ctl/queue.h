@@ -20,6 +20,8 @@
 #define clear __CLEAR
 #define ranged_sort __RANGED_SORT
 #define sort __SORT
+#define stable_sort __STABLE_SORT
+#define sort_parallel __SORT_PARALLEL
 #define range __RANGE
 #define each __each
 #define step __STEP
@@ -45,6 +47,8 @@
 #undef clear
 #undef ranged_sort
 #undef sort
+#undef stable_sort
+#undef sort_parallel
 #undef range
 #undef each
 #undef step
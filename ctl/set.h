@@ -14,6 +14,7 @@
 #define GI JOIN(A, it)
 
 #include <ctl/ctl.h>
+#include <ctl/bits/alloc.h>
 #include <stdbool.h>
 
 typedef struct B
@@ -271,7 +272,7 @@ static inline void JOIN(A, free_node)(A *self, B *node)
 #else
     (void)self;
 #endif
-    free(node);
+    CTL_FREE(node);
 }
 
 static inline int JOIN(B, color)(B *node)
@@ -309,7 +310,7 @@ static inline B *JOIN(B, uncle)(B *node)
 
 static inline B *JOIN(B, init)(T key, int color)
 {
-    B *node = (B *)malloc(sizeof(B));
+    B *node = (B *)CTL_ALLOC(sizeof(B));
     node->value = key;
     node->color = color;
     node->l = node->r = node->p = NULL;
@@ -321,7 +322,7 @@ static inline B *JOIN(A, find_node)(A *self, T key)
     B *node = self->root;
     while (node)
     {
-        int diff = self->compare(&key, &node->value);
+        int diff = _CTL_COMPARE(self->compare, &key, &node->value);
         // digi debugging only
         // LOG("key < node: %d < %d = %d\n", *key.value, *node->value.value, diff);
         // Don't rely on a valid 3-way compare. can be just a simple 2way <
@@ -336,7 +337,7 @@ static inline B *JOIN(A, find_node)(A *self, T key)
             }
             else
             {
-                int diff2 = self->compare(&node->value, &key);
+                int diff2 = _CTL_COMPARE(self->compare, &node->value, &key);
                 if (diff2 > 0)
                     node = node->r; // 2way greater
                 else if (diff2 == 0)
@@ -349,7 +350,7 @@ static inline B *JOIN(A, find_node)(A *self, T key)
         }
         else if (diff < 0) // 3-way lower
             node = node->l;
-        else if (self->compare(&node->value, &key) < 0)
+        else if (_CTL_COMPARE(self->compare, &node->value, &key) < 0)
             node = node->r; // 3way greater
         else
             node = node->l; // 2way lower
@@ -373,10 +374,10 @@ static inline bool JOIN(A, find_range)(I *range, T key)
     A *self = range->container;
     I found = JOIN(A, find)(self, key);
     // found and range.begin <= found
-    if (!JOIN(I, done)(&found) && !self->compare(found.ref, range->ref))
+    if (!JOIN(I, done)(&found) && !_CTL_COMPARE(self->compare, found.ref, range->ref))
     {
         // no, if not found < range.end
-        if (range->end && !self->compare(found.ref, &range->end->value))
+        if (range->end && !_CTL_COMPARE(self->compare, found.ref, &range->end->value))
             goto not_found;
         *range = found;
         return true;
@@ -536,12 +537,12 @@ static inline B *JOIN(A, insert)(A *self, T key)
                         self->free(&key);
                     return node;
                 }
-                diff = self->compare(&key, &node->value);
+                diff = _CTL_COMPARE(self->compare, &key, &node->value);
             }
             else
             {
-                diff = self->compare(&key, &node->value);
-                if (diff == 0 && !self->compare(&node->value, &key))
+                diff = _CTL_COMPARE(self->compare, &key, &node->value);
+                if (diff == 0 && !_CTL_COMPARE(self->compare, &node->value, &key))
                 { // equal
                     if (self->free)
                         self->free(&key);
@@ -549,7 +550,7 @@ static inline B *JOIN(A, insert)(A *self, T key)
                 }
             }
             if (diff < 0                               // 3way lower
-                || !self->compare(&node->value, &key)) // or 2way lower
+                || !_CTL_COMPARE(self->compare, &node->value, &key)) // or 2way lower
             {
                 if (node->l)
                     node = node->l;
@@ -606,12 +607,12 @@ static inline B *JOIN(A, insert_found)(A *self, T key, int *foundp)
                         self->free(&key);
                     return node;
                 }
-                diff = self->compare(&key, &node->value);
+                diff = _CTL_COMPARE(self->compare, &key, &node->value);
             }
             else
             {
-                diff = self->compare(&key, &node->value);
-                if (diff == 0 && !self->compare(&node->value, &key))
+                diff = _CTL_COMPARE(self->compare, &key, &node->value);
+                if (diff == 0 && !_CTL_COMPARE(self->compare, &node->value, &key))
                 { // equal
                     *foundp = 1;
                     if (self->free)
@@ -620,7 +621,7 @@ static inline B *JOIN(A, insert_found)(A *self, T key, int *foundp)
                 }
             }
             if (diff < 0                               // 3way lower
-                || !self->compare(&node->value, &key)) // or 2way lower
+                || !_CTL_COMPARE(self->compare, &node->value, &key)) // or 2way lower
             {
                 if (node->l)
                     node = node->l;
@@ -1222,6 +1223,13 @@ not_found:
 
 #ifndef HOLD
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef NOT_INTEGRAL
 #undef T
 #undef A
@@ -0,0 +1,258 @@
+/* Concurrent unordered_map, sharded into sub-tables with a lock each.
+   SPDX-License-Identifier: MIT
+
+   The mixed key hash picks one of the shards, a umap_T with its own mutex,
+   so threads working on different shards do not wait for each other. Every
+   method locks only the shard of its key. There are no iterators: elements
+   are only accessed under the shard lock, by copying them out with find, or
+   by foreach_parallel.
+
+   The sub-tables are umap_T from <ctl/unordered_map.h>, with all its
+   policies. Do not include <ctl/unordered_map.h> with the same T again.
+   Needs pthreads, link with -pthread.
+
+   CTL_SHMAP_SHARDS defaults to 64, a power of 2 a few times the number of
+   threads is best.
+*/
+
+#ifndef T
+#error "Template struct type T undefined for <ctl/sharded_map.h>"
+#endif
+
+#include <ctl/ctl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifndef CTL_SHMAP_SHARDS
+#define CTL_SHMAP_SHARDS 64
+#endif
+#ifndef CTL_SHMAP_CACHE_LINE
+#define CTL_SHMAP_CACHE_LINE 64
+#endif
+
+#pragma push_macro("T")
+#include <ctl/unordered_map.h>
+#pragma pop_macro("T")
+
+#define CTL_SHMAP
+#define A JOIN(shmap, T)
+#define M JOIN(umap, T)
+
+typedef struct JOIN(A, shard)
+{
+    pthread_mutex_t lock;
+    M map;
+    // against false sharing of the locks
+    char pad[CTL_SHMAP_CACHE_LINE - (sizeof(pthread_mutex_t) + sizeof(M)) % CTL_SHMAP_CACHE_LINE];
+} JOIN(A, shard);
+
+typedef struct A
+{
+    JOIN(A, shard) *shards;
+    size_t shard_count;
+    size_t (*hash)(T *);
+    int (*equal)(T *, T *);
+} A;
+
+// the shard of the value. fastrange uses the high bits of the mixed hash,
+// the sub-tables the low ones.
+static inline JOIN(A, shard) *JOIN(A, _shard)(A *self, T *value)
+{
+    const size_t i = ctl_fastrange(ctl_hash_int(self->hash(value)), self->shard_count);
+    return &self->shards[i];
+}
+
+static inline A JOIN(A, init_shards)(size_t (*_hash)(T *), int (*_equal)(T *, T *), size_t count)
+{
+    static A zero;
+    A self = zero;
+    ASSERT(count || !"no shards");
+    self.shards = (JOIN(A, shard) *)aligned_alloc(CTL_SHMAP_CACHE_LINE, count * sizeof(JOIN(A, shard)));
+    ASSERT(self.shards && "out of memory");
+    self.shard_count = count;
+    for (size_t i = 0; i < count; i++)
+    {
+        pthread_mutex_init(&self.shards[i].lock, NULL);
+        self.shards[i].map = JOIN(M, init)(_hash, _equal);
+    }
+    // with INTEGRAL T the defaults
+    self.hash = self.shards[0].map.hash;
+    self.equal = self.shards[0].map.equal;
+    return self;
+}
+
+static inline A JOIN(A, init)(size_t (*_hash)(T *), int (*_equal)(T *, T *))
+{
+    return JOIN(A, init_shards)(_hash, _equal, CTL_SHMAP_SHARDS);
+}
+
+static inline void JOIN(A, free)(A *self)
+{
+    for (size_t i = 0; i < self->shard_count; i++)
+    {
+        JOIN(M, free)(&self->shards[i].map);
+        pthread_mutex_destroy(&self->shards[i].lock);
+    }
+    free(self->shards);
+    self->shards = NULL;
+    self->shard_count = 0;
+}
+
+static inline void JOIN(A, clear)(A *self)
+{
+    for (size_t i = 0; i < self->shard_count; i++)
+    {
+        pthread_mutex_lock(&self->shards[i].lock);
+        JOIN(M, clear)(&self->shards[i].map);
+        pthread_mutex_unlock(&self->shards[i].lock);
+    }
+}
+
+// a snapshot, as other threads may change it meanwhile
+static inline size_t JOIN(A, size)(A *self)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < self->shard_count; i++)
+    {
+        pthread_mutex_lock(&self->shards[i].lock);
+        size += self->shards[i].map.size;
+        pthread_mutex_unlock(&self->shards[i].lock);
+    }
+    return size;
+}
+
+static inline bool JOIN(A, empty)(A *self)
+{
+    return JOIN(A, size)(self) == 0;
+}
+
+// assumes an even spread over the shards
+static inline void JOIN(A, reserve)(A *self, size_t desired_count)
+{
+    const size_t per_shard = desired_count / self->shard_count + 1;
+    for (size_t i = 0; i < self->shard_count; i++)
+    {
+        pthread_mutex_lock(&self->shards[i].lock);
+        JOIN(M, reserve)(&self->shards[i].map, per_shard);
+        pthread_mutex_unlock(&self->shards[i].lock);
+    }
+}
+
+// keeps an existing element, and frees value then
+static inline void JOIN(A, insert)(A *self, T value)
+{
+    JOIN(A, shard) *shard = JOIN(A, _shard)(self, &value);
+    pthread_mutex_lock(&shard->lock);
+    JOIN(M, insert)(&shard->map, value);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+// Replaces an existing element with the same key, freeing the old one.
+// Returns true if value was inserted, false if assigned.
+static inline bool JOIN(A, insert_or_assign)(A *self, T value)
+{
+    JOIN(A, shard) *shard = JOIN(A, _shard)(self, &value);
+    pthread_mutex_lock(&shard->lock);
+    JOIN(M, node) *node = JOIN(M, find_node)(&shard->map, value);
+    if (node)
+    {
+        if (shard->map.free)
+            shard->map.free(&node->value);
+        node->value = value; // the same key, the same hash
+    }
+    else
+    {
+        JOIN(M, _pre_insert_grow)(&shard->map);
+        JOIN(M, push_cached)(&shard->map, &value);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return node == NULL;
+}
+
+// Copies the found element into *result, which must be freed then.
+// Does not consume the key.
+static inline bool JOIN(A, find)(A *self, T key, T *result)
+{
+    JOIN(A, shard) *shard = JOIN(A, _shard)(self, &key);
+    pthread_mutex_lock(&shard->lock);
+    JOIN(M, node) *node = JOIN(M, find_node)(&shard->map, key);
+    if (node)
+        *result = shard->map.copy(&node->value);
+    pthread_mutex_unlock(&shard->lock);
+    return node != NULL;
+}
+
+static inline bool JOIN(A, contains)(A *self, T key)
+{
+    JOIN(A, shard) *shard = JOIN(A, _shard)(self, &key);
+    pthread_mutex_lock(&shard->lock);
+    const bool found = JOIN(M, contains)(&shard->map, key);
+    pthread_mutex_unlock(&shard->lock);
+    return found;
+}
+
+static inline void JOIN(A, erase)(A *self, T key)
+{
+    JOIN(A, shard) *shard = JOIN(A, _shard)(self, &key);
+    pthread_mutex_lock(&shard->lock);
+    JOIN(M, erase)(&shard->map, key);
+    pthread_mutex_unlock(&shard->lock);
+}
+
+typedef struct JOIN(A, _foreach_job)
+{
+    A *self;
+    void (*fn)(T *, void *);
+    void *arg;
+    size_t first;
+    size_t step;
+} JOIN(A, _foreach_job);
+
+static inline void *JOIN(A, _foreach_shards)(void *p)
+{
+    JOIN(A, _foreach_job) *job = (JOIN(A, _foreach_job) *)p;
+    A *self = job->self;
+    for (size_t i = job->first; i < self->shard_count; i += job->step)
+    {
+        pthread_mutex_lock(&self->shards[i].lock);
+        foreach (M, &self->shards[i].map, it)
+            job->fn(it.ref, job->arg);
+        pthread_mutex_unlock(&self->shards[i].lock);
+    }
+    return NULL;
+}
+
+// Calls fn(element, arg) on all elements, from threads threads (0: one per
+// shard), each locking its shards in turn. fn may modify the value, but not
+// the key, and is called concurrently.
+static inline void JOIN(A, foreach_parallel)(A *self, void (*fn)(T *, void *), void *arg, size_t threads)
+{
+    if (!threads || threads > self->shard_count)
+        threads = self->shard_count;
+    pthread_t *tids = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    JOIN(A, _foreach_job) *jobs = (JOIN(A, _foreach_job) *)malloc(threads * sizeof(JOIN(A, _foreach_job)));
+    ASSERT(tids && jobs && "out of memory");
+    size_t started = 0;
+    for (size_t t = 0; t < threads; t++)
+    {
+        JOIN(A, _foreach_job) job = {self, fn, arg, t, threads};
+        jobs[t] = job;
+    }
+    // the first job runs in the caller, as the jobs without a thread
+    for (size_t t = 1; t < threads; t++)
+        if (pthread_create(&tids[started], NULL, JOIN(A, _foreach_shards), &jobs[t]) == 0)
+            started++;
+        else
+            JOIN(A, _foreach_shards)(&jobs[t]);
+    JOIN(A, _foreach_shards)(&jobs[0]);
+    for (size_t t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    free(jobs);
+    free(tids);
+}
+
+#undef CTL_SHMAP
+#undef T
+#undef A
+#undef M
@@ -0,0 +1,20 @@
+/* A vector with inline storage for up to N elements, spilling to the heap
+   when it grows over N. deriving from vector.
+   SPDX-License-Identifier: MIT */
+
+#ifndef T
+#error "Template type T undefined for <ctl/small_vector.h>"
+#endif
+#ifndef N
+#error "Size N undefined for <ctl/small_vector.h>"
+#endif
+#if N < 1 || N > (4294967296 / 8)
+#error "Size N invalid for <ctl/small_vector.h>"
+#endif
+
+#define CTL_SVEC
+#define vec PASTE(svec, N)
+#include <ctl/vector.h>
+#undef vec
+#undef CTL_SVEC
+#undef N
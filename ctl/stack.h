@@ -21,6 +21,8 @@
 #define clear __CLEAR
 #define ranged_sort __RANGED_SORT
 #define sort __SORT
+#define stable_sort __STABLE_SORT
+#define sort_parallel __SORT_PARALLEL
 #define range __RANGE
 #define each __EACH
 #define step __STEP
@@ -52,6 +54,8 @@
 #undef clear
 #undef ranged_sort
 #undef sort
+#undef stable_sort
+#undef sort_parallel
 #undef range
 #undef each
 #undef step
@@ -1,4 +1,4 @@
-/* A vector class
+/* A vector class. Short strings are kept inline, without allocation.
    SPDX-License-Identifier: MIT */
 #ifndef __CTL_STRING__H__
 #define __CTL_STRING__H__
@@ -18,6 +18,17 @@
 #define T char
 #define vec_char str
 #define MUST_ALIGN_16(T) (sizeof(T) == sizeof(char))
+// the inline capacity, as of the STL
+#ifndef _LIBCPP_STD_VER
+#define CTL_STR_SSO 15
+#else
+#define CTL_STR_SSO 22
+#endif
+// str_searcher needles from this size on skip by their Horspool shifts,
+// without SIMD
+#ifndef CTL_STR_SEARCHER_MIN
+#define CTL_STR_SEARCHER_MIN 64
+#endif
 #define str_init str___INIT
 #define str_equal str___EQUAL
 #define str_find str___FIND
@@ -26,7 +37,7 @@
 
 #define str_foreach(self, it)                                                                                          \
     if ((self)->size)                                                                                                  \
-        for (char *it = &(self)->vector[0]; it < &(self)->vector[(self)->size]; it++)
+        for (char *it = str_data(self); it < &str_data(self)[(self)->size]; it++)
 #define str_foreach_range(it, first, last)                                                                             \
     if (last)                                                                                                          \
         for (char *it = first; it < last; it++)
@@ -42,15 +53,16 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <ctl/bits/hash.h>
 
 static inline char *str_begin(str *self)
 {
-    return &self->vector[0];
+    return str_data(self);
 }
 
 static inline char *str_end(str *self)
 {
-    return &self->vector[self->size];
+    return &str_data(self)[self->size];
 }
 
 // if we compare char by char, for algorithms like sort
@@ -64,43 +76,52 @@ static inline int str_char_equal(char *a, char *b)
     return *a == *b;
 }
 
-static inline str str_init(const char *c_str)
+// the first len characters of s, e.g. of a strview
+static inline str str__init_n(const char *s, size_t len)
 {
     str self = str___INIT();
-    size_t len = strlen(c_str);
+    self.compare = str_char_compare;
+    self.equal = str_char_equal;
+    if (len > CTL_STR_SSO)
 #ifndef _LIBCPP_STD_VER
-    size_t min = 15;
+        str_fit(&self, len);
 #else
-    size_t min = 22;
+        str_fit(&self, len | 15);
 #endif
-    self.compare = str_char_compare;
-    self.equal = str_char_equal;
-    str_reserve(&self, len < min ? min : len);
-    for (const char *s = c_str; *s; s++)
-        str_push_back(&self, *s);
+    // the fresh storage is zeroed, with the \0
+    memcpy(str_data(&self), s, len);
+    self.size = len;
     return self;
 }
 
-static inline void str_append(str *self, const char *s)
+static inline str str_init(const char *c_str)
 {
-    size_t start = self->size;
-    size_t len = strlen(s);
-    str_resize(self, self->size + len, '\0');
-    for (size_t i = 0; i < len; i++)
-        self->vector[start + i] = s[i];
+    return str__init_n(c_str, strlen(c_str));
 }
 
-static inline void str_insert_str(str *self, size_t index, const char *s)
+// Opens count characters at index, grown as with resize. The inserted C
+// strings must not point into self.
+static inline char *str__open(str *self, size_t index, size_t count)
 {
-    size_t start = self->size;
-    size_t len = strlen(s);
-    str_resize(self, self->size + len, '\0');
-    self->size = start;
-    while (len != 0)
+    const size_t size = self->size + count;
+    if (size > self->capacity)
     {
-        len--;
-        str_insert_index(self, index, s[len]);
+        const size_t capacity = 2 * self->capacity;
+        str_reserve(self, size > capacity ? size : capacity);
     }
+    return str__gap(self, index, count);
+}
+
+static inline void str_append(str *self, const char *s)
+{
+    const size_t len = strlen(s);
+    memcpy(str__open(self, self->size, len), s, len);
+}
+
+static inline void str_insert_str(str *self, size_t index, const char *s)
+{
+    const size_t len = strlen(s);
+    memcpy(str__open(self, index, len), s, len);
 }
 
 static inline void str_replace(str *self, size_t index, size_t size, const char *s)
@@ -108,9 +129,18 @@ static inline void str_replace(str *self, size_t index, size_t size, const char
     size_t end = index + size;
     if (end >= self->size)
         end = self->size;
-    for (size_t i = index; i < end; i++)
-        str_erase_index(self, index);
-    str_insert_str(self, index, s);
+    const size_t count = end - index;
+    const size_t len = strlen(s);
+    if (len > count)
+        str__open(self, end, len - count);
+    else if (len < count)
+    {
+        char *data = str_data(self);
+        memmove(&data[index + len], &data[end], self->size - end);
+        self->size -= count - len;
+        data[self->size] = '\0';
+    }
+    memcpy(&str_data(self)[index], s, len);
 }
 
 static inline char *str_c_str(str *self)
@@ -118,69 +148,295 @@ static inline char *str_c_str(str *self)
     return str_data(self);
 }
 
-static inline size_t str_find(str *self, const char *s)
+// The first index of the needle n in the haystack h, or SIZE_MAX. Tests
+// the first and last needle character at a register of positions at once,
+// and compares only there.
+static inline size_t str__search(const char *h, size_t hsize, const char *n, size_t nsize)
 {
-    char *c_str = self->vector;
-    char *found = strstr(c_str, s);
-    if (found)
-        return found - c_str;
+    if (nsize > hsize)
+        return SIZE_MAX;
+    if (nsize == 0)
+        return 0;
+    const size_t starts = hsize - nsize + 1;
+    size_t i = 0;
+#if CTL_SIMD_WIDTH
+    const _ctl_simd_t first = str__simd_set1(n[0]);
+    const _ctl_simd_t last = str__simd_set1(n[nsize - 1]);
+    for (; i + 2 * CTL_SIMD_WIDTH <= starts; i += 2 * CTL_SIMD_WIDTH)
+    {
+        const char *t = &h[i + nsize - 1];
+        uint64_t m = (_ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i]), first)) &
+                      _ctl_simd_mask(str__simd_eq(_ctl_simd_load(t), last))) |
+                     (_ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i + CTL_SIMD_WIDTH]), first)) &
+                      _ctl_simd_mask(str__simd_eq(_ctl_simd_load(&t[CTL_SIMD_WIDTH]), last)))
+                         << CTL_SIMD_WIDTH;
+        for (; m; m &= m - 1)
+        {
+            const size_t j = i + __builtin_ctzll(m);
+            if (!memcmp(&h[j], n, nsize))
+                return j;
+        }
+    }
+    for (; i + CTL_SIMD_WIDTH <= starts; i += CTL_SIMD_WIDTH)
+    {
+        uint64_t m = _ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i]), first)) &
+                     _ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i + nsize - 1]), last));
+        for (; m; m &= m - 1)
+        {
+            const size_t j = i + __builtin_ctzll(m);
+            if (!memcmp(&h[j], n, nsize))
+                return j;
+        }
+    }
+#else
+    // the same filter 8 positions per word: a zero byte where both match
+    const uint64_t ones = UINT64_C(0x0101010101010101), high = ones << 7;
+    const uint64_t first = ones * (unsigned char)n[0], last = ones * (unsigned char)n[nsize - 1];
+    for (; i + 8 <= starts; i += 8)
+    {
+        uint64_t a, b;
+        memcpy(&a, &h[i], 8);
+        memcpy(&b, &h[i + nsize - 1], 8);
+        const uint64_t v = (a ^ first) | (b ^ last);
+        if ((v - ones) & ~v & high)
+            for (size_t j = i; j < i + 8; j++)
+                if (h[j] == n[0] && !memcmp(&h[j], n, nsize))
+                    return j;
+    }
+#endif
+    for (; i < starts; i++)
+        if (h[i] == n[0] && !memcmp(&h[i], n, nsize))
+            return i;
+    return SIZE_MAX;
+}
+
+// The last index of the needle n in the haystack h, or SIZE_MAX
+static inline size_t str__rsearch(const char *h, size_t hsize, const char *n, size_t nsize)
+{
+    if (nsize > hsize)
+        return SIZE_MAX;
+    if (nsize == 0)
+        return hsize;
+    size_t starts = hsize - nsize + 1;
+#if CTL_SIMD_WIDTH
+    const _ctl_simd_t first = str__simd_set1(n[0]);
+    const _ctl_simd_t last = str__simd_set1(n[nsize - 1]);
+    for (; starts >= CTL_SIMD_WIDTH; starts -= CTL_SIMD_WIDTH)
+    {
+        const size_t i = starts - CTL_SIMD_WIDTH;
+        uint64_t m = _ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i]), first)) &
+                     _ctl_simd_mask(str__simd_eq(_ctl_simd_load(&h[i + nsize - 1]), last));
+        while (m)
+        {
+            const size_t bit = 63 - __builtin_clzll(m);
+            if (!memcmp(&h[i + bit], n, nsize))
+                return i + bit;
+            m &= ~(UINT64_C(1) << bit);
+        }
+    }
+#endif
+    while (starts--)
+        if (h[starts] == n[0] && !memcmp(&h[starts], n, nsize))
+            return starts;
     return SIZE_MAX;
 }
 
+static inline size_t str_find(str *self, const char *s)
+{
+    return str__search(str_data(self), self->size, s, strlen(s));
+}
+
+// finds the first n characters of s, which may contain \0
+static inline size_t str_find_n(str *self, const char *s, size_t n)
+{
+    return str__search(str_data(self), self->size, s, n);
+}
+
 static inline int str_count(str *self, char c)
 {
     size_t count = 0;
     for (size_t i = 0; i < self->size; i++)
-        if (self->vector[i] == c)
+        if (str_data(self)[i] == c)
             count++;
     return count;
 }
 
 static inline size_t str_rfind(str *self, const char *s)
 {
-    char *c_str = self->vector;
-    for (size_t i = self->size; i != SIZE_MAX; i--)
+    return str__rsearch(str_data(self), self->size, s, strlen(s));
+}
+
+// A needle compiled once for repeated searches. The needle is not copied and
+// must outlive the searcher. Without SIMD long needles skip by their Horspool
+// shifts, with SIMD the register filter of str_find is faster for all sizes.
+typedef struct str_searcher
+{
+    const char *needle;
+    size_t size;
+#if !CTL_SIMD_WIDTH
+    size_t shift[256];
+#endif
+} str_searcher;
+
+static inline str_searcher str_searcher_init(const char *needle)
+{
+    str_searcher self;
+    self.needle = needle;
+    self.size = strlen(needle);
+#if !CTL_SIMD_WIDTH
+    for (size_t c = 0; c < 256; c++)
+        self.shift[c] = self.size;
+    for (size_t i = 0; i + 1 < self.size; i++)
+        self.shift[(unsigned char)needle[i]] = self.size - 1 - i;
+#endif
+    return self;
+}
+
+// The first index of the needle in s from index from on, or SIZE_MAX
+static inline size_t str_searcher_find(str_searcher *self, str *s, size_t from)
+{
+    if (from > s->size)
+        return SIZE_MAX;
+    const char *h = &str_data(s)[from];
+    const size_t hsize = s->size - from;
+    const size_t nsize = self->size;
+#if !CTL_SIMD_WIDTH
+    if (nsize >= CTL_STR_SEARCHER_MIN && nsize <= hsize)
     {
-        char *found = strstr(&c_str[i], s);
-        if (found)
-            return found - c_str;
+        const unsigned char last = (unsigned char)self->needle[nsize - 1];
+        for (size_t i = 0; i + nsize <= hsize;)
+        {
+            const unsigned char c = (unsigned char)h[i + nsize - 1];
+            if (c == last && !memcmp(&h[i], self->needle, nsize - 1))
+                return from + i;
+            i += self->shift[c];
+        }
+        return SIZE_MAX;
     }
-    return SIZE_MAX;
+#endif
+    const size_t i = str__search(h, hsize, self->needle, nsize);
+    return i == SIZE_MAX ? i : from + i;
 }
 
-// i.e. strcspn, but returning the first found match
-static inline bool str_find_first_of_range(str_it *range1, str_it *range2)
+// A set of bytes for the find_*_of family, built once per call: bit c%8 of
+// bits[c/8]. For the shuffle lookups rather bit h%8 of lo[l] for the bytes
+// h<<4|l under 0x80, and of hi[l] for the others.
+typedef struct str__set
 {
+#ifdef _CTL_SIMD_SHUFFLE
+    uint8_t lo[16];
+    uint8_t hi[16];
+#else
+    uint8_t bits[32];
+#endif
+} str__set;
 
-    if (str_it_done(range1) || str_it_done(range2))
-        return false;
-    str *self = range1->container;
-    str *other = range2->container;
-    // temp. set \0 at range1->end and range2->end.
-    // this looks expensive, but glibc is much faster than naively as below.
-    // it splits range2 into 4 parallelizable tables.
-    char e1 = 0, e2 = 0;
-    size_t off;
-    if (range1->end != &self->vector[self->size])
+static inline void str__set_init(str__set *set, const char *s, size_t n)
+{
+    memset(set, 0, sizeof(*set));
+    for (size_t i = 0; i < n; i++)
+    {
+        const unsigned char c = (unsigned char)s[i];
+#ifdef _CTL_SIMD_SHUFFLE
+        (c < 0x80 ? set->lo : set->hi)[c & 15] |= (uint8_t)(1 << ((c >> 4) & 7));
+#else
+        set->bits[c >> 3] |= (uint8_t)(1 << (c & 7));
+#endif
+    }
+}
+
+static inline bool str__set_has(const str__set *set, char c)
+{
+    const unsigned char u = (unsigned char)c;
+#ifdef _CTL_SIMD_SHUFFLE
+    return ((u < 0x80 ? set->lo : set->hi)[u & 15] >> ((u >> 4) & 7)) & 1;
+#else
+    return (set->bits[u >> 3] >> (u & 7)) & 1;
+#endif
+}
+
+#ifdef _CTL_SIMD_SHUFFLE
+// One mask bit per byte of p in the set. The lo row is looked up by the
+// byte itself, and shuffles to 0 for the bytes over 0x80, the hi row with
+// the top bit flipped. The high nibble selects the bit of the row.
+static inline uint64_t str__set_mask(const str__set *set, const char *p)
+{
+    static const uint8_t bit[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+#if CTL_SIMD_WIDTH == 32
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->lo));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)set->hi));
+    const __m256i bits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)bit));
+    const __m256i x = _mm256_loadu_si256((const __m256i *)p);
+    const __m256i index = _mm256_set1_epi8((char)0x8f);
+    const __m256i row =
+        _mm256_or_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(x, index)),
+                        _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_xor_si256(x, _mm256_set1_epi8((char)0x80)), index)));
+    const __m256i b =
+        _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0f)));
+    return _ctl_simd_mask(_mm256_cmpeq_epi8(_mm256_and_si256(row, b), b));
+#else
+    const __m128i lo = _mm_loadu_si128((const __m128i *)set->lo);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)set->hi);
+    const __m128i bits = _mm_loadu_si128((const __m128i *)bit);
+    const __m128i x = _mm_loadu_si128((const __m128i *)p);
+    const __m128i index = _mm_set1_epi8((char)0x8f);
+    const __m128i row = _mm_or_si128(_mm_shuffle_epi8(lo, _mm_and_si128(x, index)),
+                                     _mm_shuffle_epi8(hi, _mm_and_si128(_mm_xor_si128(x, _mm_set1_epi8((char)0x80)), index)));
+    const __m128i b = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0f)));
+    return _ctl_simd_mask(_mm_cmpeq_epi8(_mm_and_si128(row, b), b));
+#endif
+}
+#endif
+
+// The first index of p with a byte in the set, or with !in not in the set.
+// SIZE_MAX if none.
+static inline size_t str__find_of(const char *p, size_t size, const str__set *set, bool in)
+{
+    size_t i = 0;
+#ifdef _CTL_SIMD_SHUFFLE
+    const uint64_t flip = in ? 0 : _CTL_SIMD_ALL;
+    for (; i + CTL_SIMD_WIDTH <= size; i += CTL_SIMD_WIDTH)
     {
-        e1 = *range1->end;
-        *range1->end = '\0';
+        const uint64_t m = str__set_mask(set, &p[i]) ^ flip;
+        if (m)
+            return i + __builtin_ctzll(m);
     }
-    if (UNLIKELY(range2->end != &other->vector[other->size]))
+#endif
+    for (; i < size; i++)
+        if (str__set_has(set, p[i]) == in)
+            return i;
+    return SIZE_MAX;
+}
+
+// The same from the end
+static inline size_t str__rfind_of(const char *p, size_t size, const str__set *set, bool in)
+{
+#ifdef _CTL_SIMD_SHUFFLE
+    const uint64_t flip = in ? 0 : _CTL_SIMD_ALL;
+    for (; size >= CTL_SIMD_WIDTH; size -= CTL_SIMD_WIDTH)
     {
-        e2 = *range2->end;
-        *range2->end = '\0';
+        const uint64_t m = str__set_mask(set, &p[size - CTL_SIMD_WIDTH]) ^ flip;
+        if (m)
+            return size - CTL_SIMD_WIDTH + 63 - __builtin_clzll(m);
     }
-    off = strcspn(range1->ref, range2->ref);
-    if (e1)
-        *range1->end = e1;
-    if (UNLIKELY(e2))
-        *range2->end = e2;
-    size_t start1 = range1->ref - self->vector;
-    off += start1;
-    if (&self->vector[off] < range1->end)
+#endif
+    while (size--)
+        if (str__set_has(set, p[size]) == in)
+            return size;
+    return SIZE_MAX;
+}
+
+// i.e. std::find_first_of, with range2 as the set
+static inline bool str_find_first_of_range(str_it *range1, str_it *range2)
+{
+    if (str_it_done(range1) || str_it_done(range2))
+        return false;
+    str__set set;
+    str__set_init(&set, range2->ref, range2->end - range2->ref);
+    const size_t off = str__find_of(range1->ref, range1->end - range1->ref, &set, true);
+    if (off != SIZE_MAX)
     {
-        range1->ref = &self->vector[off];
+        range1->ref += off;
         return true;
     }
     else
@@ -193,53 +449,30 @@ static inline bool str_find_first_of_range(str_it *range1, str_it *range2)
 // see algorithm.h for the range variant
 static inline size_t str_find_first_of(str *self, const char *s)
 {
-#if 1
-    size_t i = strcspn(self->vector, s);
-    return i >= self->size ? SIZE_MAX : i;
-#else
-    for (size_t i = 0; i < self->size; i++)
-        for (const char *p = s; *p; p++)
-            if (self->vector[i] == *p)
-                return i;
-    return SIZE_MAX;
-#endif
+    str__set set;
+    str__set_init(&set, s, strlen(s));
+    return str__find_of(str_data(self), self->size, &set, true);
 }
 
 static inline size_t str_find_last_of(str *self, const char *s)
 {
-    for (size_t i = self->size; i != SIZE_MAX; i--)
-        for (const char *p = s; *p; p++)
-            if (self->vector[i] == *p)
-                return i;
-    return SIZE_MAX;
+    str__set set;
+    str__set_init(&set, s, strlen(s));
+    return str__rfind_of(str_data(self), self->size, &set, true);
 }
 
 static inline size_t str_find_first_not_of(str *self, const char *s)
 {
-    for (size_t i = 0; i < self->size; i++)
-    {
-        size_t count = 0;
-        for (const char *p = s; *p; p++)
-            if (self->vector[i] == *p)
-                count++;
-        if (count == 0)
-            return i;
-    }
-    return SIZE_MAX;
+    str__set set;
+    str__set_init(&set, s, strlen(s));
+    return str__find_of(str_data(self), self->size, &set, false);
 }
 
 static inline size_t str_find_last_not_of(str *self, const char *s)
 {
-    for (size_t i = self->size - 1; i != SIZE_MAX; i--)
-    {
-        size_t count = 0;
-        for (const char *p = s; *p; p++)
-            if (self->vector[i] == *p)
-                count++;
-        if (count == 0)
-            return i;
-    }
-    return SIZE_MAX;
+    str__set set;
+    str__set_init(&set, s, strlen(s));
+    return str__rfind_of(str_data(self), self->size, &set, false);
 }
 
 static inline str str_substr(str *self, size_t index, size_t size)
@@ -249,14 +482,14 @@ static inline str str_substr(str *self, size_t index, size_t size)
 #endif
     str_resize(&substr, size, '\0');
     for (size_t i = 0; i < size; i++)
-        substr.vector[i] = self->vector[index + i];
+        str_data(&substr)[i] = str_data(self)[index + i];
     return substr;
 }
 
 /* STL clash */
 static inline int str_compare(str *self, const char *s)
 {
-    return strcmp(self->vector, s);
+    return strcmp(str_data(self), s);
 }
 
 /* STL clash
@@ -267,17 +500,144 @@ str_equal(str* self, const char* s)
 }
 */
 
+// by size, as the key may be a strview_key without \0
 static inline int str_key_compare(str *self, str *other)
 {
-    return strcmp(self->vector, other->vector);
+    const size_t size = self->size < other->size ? self->size : other->size;
+    const int cmp = memcmp(str_data(self), str_data(other), size);
+    if (cmp || self->size == other->size)
+        return cmp;
+    return self->size < other->size ? -1 : 1;
 }
 
 static inline int str_equal(str *self, str *other)
 {
-    return strcmp(self->vector, other->vector) == 0;
+    return self->size == other->size && !memcmp(str_data(self), str_data(other), self->size);
+}
+
+// the default hash, e.g. for a uset_str or umap_str key
+static inline size_t str_hash(str *self)
+{
+    return ctl_hash_bytes(str_data(self), self->size, 0);
+}
+
+// A non-owning view of size characters at data, e.g. a token of a larger
+// buffer, without \0. Passed by value. Views are never freed, and must not
+// outlive their characters.
+typedef struct strview
+{
+    const char *data;
+    size_t size;
+} strview;
+
+static inline strview strview_init(const char *s)
+{
+    strview self = {s, strlen(s)};
+    return self;
+}
+
+static inline strview strview_init_n(const char *s, size_t size)
+{
+    strview self = {s, size};
+    return self;
+}
+
+// the view of a str, until it is changed
+static inline strview str_view(str *self)
+{
+    strview view = {str_data(self), self->size};
+    return view;
+}
+
+// as str_substr, but without a copy
+static inline strview str_substr_view(str *self, size_t index, size_t size)
+{
+    strview view = {&str_data(self)[index], size};
+    return view;
+}
+
+static inline strview strview_substr(strview self, size_t index, size_t size)
+{
+    strview view = {&self.data[index], size};
+    return view;
+}
+
+static inline size_t strview_find(strview self, strview needle)
+{
+    return str__search(self.data, self.size, needle.data, needle.size);
+}
+
+static inline size_t strview_rfind(strview self, strview needle)
+{
+    return str__rsearch(self.data, self.size, needle.data, needle.size);
+}
+
+static inline int strview_compare(strview self, strview other)
+{
+    const size_t size = self.size < other.size ? self.size : other.size;
+    const int cmp = memcmp(self.data, other.data, size);
+    if (cmp || self.size == other.size)
+        return cmp;
+    return self.size < other.size ? -1 : 1;
+}
+
+static inline bool strview_equal(strview self, strview other)
+{
+    return self.size == other.size && !memcmp(self.data, other.data, self.size);
+}
+
+static inline bool strview_starts_with(strview self, strview prefix)
+{
+    return self.size >= prefix.size && !memcmp(self.data, prefix.data, prefix.size);
+}
+
+static inline bool strview_ends_with(strview self, strview suffix)
+{
+    return self.size >= suffix.size && !memcmp(&self.data[self.size - suffix.size], suffix.data, suffix.size);
+}
+
+// the same as str_hash of a str with these characters
+static inline size_t strview_hash(strview self)
+{
+    return ctl_hash_bytes(self.data, self.size, 0);
+}
+
+// a new str, with a copy of the characters
+static inline str strview_str(strview self)
+{
+    return str__init_n(self.data, self.size);
+}
+
+// A str key with the characters of the view, for a lookup in a set, map, uset
+// or umap of str without an allocation, e.g. set_str_find(&set,
+// strview_key(view)). Short views are copied inline, longer ones are
+// borrowed, without \0. Only to compare and hash, never to free, change or
+// insert.
+static inline str strview_key(strview self)
+{
+    str key = str_init("");
+    if (self.size <= CTL_STR_SSO)
+    {
+        memcpy(key.small, self.data, self.size);
+        key.small[self.size] = '\0';
+    }
+    else
+    {
+        key.vector = (char *)self.data;
+        key.capacity = self.size;
+    }
+    key.size = self.size;
+    return key;
 }
 
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #ifndef HOLD
 #undef vec_char
 #undef T
@@ -0,0 +1,898 @@
+/* Open-addressing hashtable with SIMD probing of control byte groups,
+   as in Google's swisstable (abseil flat_hash_set).
+   SPDX-License-Identifier: MIT
+
+   Same API as unordered_set, but the values are stored inline in one flat
+   slot array, with one control byte per slot. No node allocations, and find,
+   insert and erase touch only the control bytes and the matching slots.
+   As with every open-addressing table, pointers and iterators into the table
+   are invalidated by inserts (rehashes) and erase.
+
+   The control bytes are EMPTY, DELETED or FULL with the 7 lower bits of the
+   hash (H2). The upper bits (H1) select the group start, and all matching
+   slots in a group are found with one compare:
+
+  - AVX2:      32 slots per group (`__AVX2__`, disable with CTL_SWISS_NO_AVX2)
+  - SSE2:      16 slots per group (`__SSE2__`)
+  - portable:  8 slots per group via SWAR on a uint64_t.
+
+  CTL_SWISS_MAX_LOAD_FACTOR defaults to 0.875 (7/8).
+*/
+
+#ifndef T
+#error "Template type T undefined for <ctl/swisstable.h>"
+#endif
+
+#include <ctl/ctl.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef __CTL_SWISSTABLE_GROUP__
+#define __CTL_SWISSTABLE_GROUP__
+
+#if defined __AVX2__ && !defined CTL_SWISS_NO_AVX2
+#include <immintrin.h>
+#define CTL_SWISS_GROUP_WIDTH 32
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CTL_SWISS_GROUP_WIDTH 16
+#else
+#define CTL_SWISS_GROUP_WIDTH 8
+#endif
+
+#ifndef CTL_SWISS_MAX_LOAD_FACTOR
+#define CTL_SWISS_MAX_LOAD_FACTOR 0.875f
+#endif
+
+#define CTL_SWISS_EMPTY ((int8_t)-128) // 0b10000000
+#define CTL_SWISS_DELETED ((int8_t)-2) // 0b11111110
+// FULL is 0b0xxxxxxx, with the H2 bits
+
+// All group matches return a bitmask with one bit per slot, bit 0 being the
+// first slot of the group.
+
+#if CTL_SWISS_GROUP_WIDTH == 32
+
+static inline uint32_t _ctl_swiss_match(const int8_t *g, int8_t h2)
+{
+    const __m256i ctrl = _mm256_loadu_si256((const __m256i *)g);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl));
+}
+
+static inline uint32_t _ctl_swiss_match_empty(const int8_t *g)
+{
+    return _ctl_swiss_match(g, CTL_SWISS_EMPTY);
+}
+
+// ctrl < -1, the sign bit alone would also do
+static inline uint32_t _ctl_swiss_match_empty_or_deleted(const int8_t *g)
+{
+    const __m256i ctrl = _mm256_loadu_si256((const __m256i *)g);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(-1), ctrl));
+}
+
+static inline uint32_t _ctl_swiss_match_full(const int8_t *g)
+{
+    const __m256i ctrl = _mm256_loadu_si256((const __m256i *)g);
+    return ~(uint32_t)_mm256_movemask_epi8(ctrl);
+}
+
+#elif CTL_SWISS_GROUP_WIDTH == 16
+
+static inline uint32_t _ctl_swiss_match(const int8_t *g, int8_t h2)
+{
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+}
+
+static inline uint32_t _ctl_swiss_match_empty(const int8_t *g)
+{
+    return _ctl_swiss_match(g, CTL_SWISS_EMPTY);
+}
+
+static inline uint32_t _ctl_swiss_match_empty_or_deleted(const int8_t *g)
+{
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl));
+}
+
+static inline uint32_t _ctl_swiss_match_full(const int8_t *g)
+{
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)g);
+    return ~(uint32_t)_mm_movemask_epi8(ctrl) & 0xffff;
+}
+
+#else // SWAR
+
+#define CTL_SWISS_LSBS UINT64_C(0x0101010101010101)
+#define CTL_SWISS_MSBS UINT64_C(0x8080808080808080)
+
+static inline uint64_t _ctl_swiss_load(const int8_t *g)
+{
+    uint64_t ctrl;
+    memcpy(&ctrl, g, sizeof(ctrl));
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    ctrl = __builtin_bswap64(ctrl);
+#endif
+    return ctrl;
+}
+
+// one bit per byte at 0x80 => one bit per slot
+static inline uint32_t _ctl_swiss_compress(uint64_t m)
+{
+    return (uint32_t)(((m >> 7) * UINT64_C(0x0102040810204080)) >> 56);
+}
+
+// May have false positives, but only on FULL slots after a real match,
+// which are then rejected by equal.
+static inline uint32_t _ctl_swiss_match(const int8_t *g, int8_t h2)
+{
+    const uint64_t x = _ctl_swiss_load(g) ^ (CTL_SWISS_LSBS * (uint8_t)h2);
+    return _ctl_swiss_compress((x - CTL_SWISS_LSBS) & ~x & CTL_SWISS_MSBS);
+}
+
+static inline uint32_t _ctl_swiss_match_empty(const int8_t *g)
+{
+    const uint64_t ctrl = _ctl_swiss_load(g);
+    return _ctl_swiss_compress(ctrl & ~(ctrl << 6) & CTL_SWISS_MSBS);
+}
+
+static inline uint32_t _ctl_swiss_match_empty_or_deleted(const int8_t *g)
+{
+    return _ctl_swiss_compress(_ctl_swiss_load(g) & CTL_SWISS_MSBS);
+}
+
+static inline uint32_t _ctl_swiss_match_full(const int8_t *g)
+{
+    return _ctl_swiss_compress(~_ctl_swiss_load(g) & CTL_SWISS_MSBS);
+}
+
+#endif // GROUP_WIDTH
+
+static inline unsigned _ctl_swiss_ctz(uint32_t m)
+{
+#ifdef __GNUC__
+    return __builtin_ctz(m);
+#else
+    unsigned n = 0;
+    while (!(m & 1))
+    {
+        m >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// leading zeros in the group bitmask
+static inline unsigned _ctl_swiss_clz(uint32_t m)
+{
+#ifdef __GNUC__
+    return __builtin_clz(m) - (32 - CTL_SWISS_GROUP_WIDTH);
+#else
+    unsigned n = 0;
+    for (uint32_t bit = 1U << (CTL_SWISS_GROUP_WIDTH - 1); !(m & bit); bit >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+// The user hash is often the identity for integers. Spread it over H1 and H2.
+static inline size_t _ctl_swiss_mix(size_t h)
+{
+    const uint64_t x = (uint64_t)h * UINT64_C(0x9E3779B97F4A7C15);
+    return (size_t)(x ^ (x >> 32));
+}
+
+#endif // __CTL_SWISSTABLE_GROUP__
+
+// share the uset policies in ctl/bits and algorithm.h
+#define CTL_USET
+#define CTL_SWISS
+#define A JOIN(swiss, T)
+#define I JOIN(A, it)
+#define GI JOIN(A, it)
+
+typedef struct A
+{
+    int8_t *ctrl; // bucket_max + 1 + CTL_SWISS_GROUP_WIDTH control bytes
+    T *slots;
+    size_t size;
+    size_t bucket_max; // index of last slot. capacity - 1, power of 2
+    size_t deleted;    // tombstones
+    size_t growth_limit;
+    float max_load_factor;
+    void (*free)(T *);
+    T (*copy)(T *);
+    size_t (*hash)(T *);
+    int (*equal)(T *, T *);
+} A;
+
+#include <ctl/bits/iterator_vtable.h>
+
+typedef struct I
+{
+    CTL_SWISS_ITER_FIELDS;
+} I;
+
+#include <ctl/bits/iterators.h>
+
+static inline size_t JOIN(A, bucket_count)(A *self)
+{
+    return self->ctrl ? self->bucket_max + 1 : 0;
+}
+
+static inline size_t JOIN(A, _hash)(A *self, T *value)
+{
+    return _ctl_swiss_mix(self->hash(value));
+}
+
+static inline int8_t JOIN(A, _h2)(size_t hash)
+{
+    return (int8_t)(hash & 0x7f);
+}
+
+static inline size_t JOIN(A, _h1)(A *self, size_t hash)
+{
+    return (hash >> 7) & self->bucket_max;
+}
+
+static inline void JOIN(A, _set_ctrl)(A *self, size_t i, int8_t h)
+{
+    self->ctrl[i] = h;
+    // the clones behind the end, for unaligned group loads at the last slots
+    if (i < CTL_SWISS_GROUP_WIDTH)
+        self->ctrl[self->bucket_max + 1 + i] = h;
+}
+
+// index of the next FULL slot at or after i, or the capacity
+static inline size_t JOIN(A, _next_full)(A *self, size_t i)
+{
+    const size_t cap = self->bucket_max + 1;
+    while (i < cap)
+    {
+        uint32_t m = _ctl_swiss_match_full(&self->ctrl[i]);
+        if (m)
+        {
+            i += _ctl_swiss_ctz(m);
+            return i < cap ? i : cap;
+        }
+        i += CTL_SWISS_GROUP_WIDTH;
+    }
+    return cap;
+}
+
+static inline I JOIN(I, iter)(A *self, size_t index);
+static inline I JOIN(A, begin)(A *self);
+static inline I JOIN(A, end)(A *self);
+
+static inline T *JOIN(I, ref)(I *iter)
+{
+    return iter->ref;
+}
+
+// We don't support swiss ranges
+static inline int JOIN(I, done)(I *iter)
+{
+    return iter->ref == NULL;
+}
+
+static inline void JOIN(I, next)(I *iter)
+{
+    A *self = iter->container;
+    ASSERT(iter->ref);
+    iter->index = JOIN(A, _next_full)(self, iter->index + 1);
+    iter->ref = iter->index <= self->bucket_max ? &self->slots[iter->index] : NULL;
+}
+
+static inline I *JOIN(I, advance)(I *iter, long i)
+{
+    if (i < 0)
+    {
+        i = iter->container->size + i;
+        I it = JOIN(A, begin)(iter->container);
+        iter->index = it.index;
+        iter->ref = it.ref;
+    }
+    for (long j = 0; j < i && iter->ref; j++)
+        JOIN(I, next)(iter);
+    return iter;
+}
+
+// advance end only (*_n algos)
+static inline void JOIN(I, advance_end)(I *iter, long n)
+{
+    (void)iter; // ignore ranges
+    (void)n;    // ignore ranges
+}
+
+// no ranges, ignore last iters
+static inline void JOIN(I, range)(I *begin, I *end)
+{
+    (void)begin;
+    (void)end;
+}
+
+static inline void JOIN(I, set_end)(I *iter, I *last)
+{
+    (void)iter; // ignore ranges
+    (void)last; // ignore ranges
+}
+
+static inline void JOIN(I, set_pos)(I *iter, I *other)
+{
+    iter->index = other->index;
+    iter->ref = other->ref;
+}
+
+static inline void JOIN(I, set_done)(I *iter)
+{
+    iter->ref = NULL;
+}
+
+// ignore
+static inline void JOIN(I, prev)(I *iter)
+{
+    (void)iter;
+}
+
+static inline int JOIN(A, _equal)(A *self, T *a, T *b)
+{
+    ASSERT(self->equal || !"equal undefined");
+    return self->equal(a, b);
+}
+
+static inline A JOIN(A, init_from)(A *copy);
+static inline A JOIN(A, copy)(A *self);
+static inline void JOIN(A, insert)(A *self, T value);
+
+static inline void JOIN(A, inserter)(A *self, T value)
+{
+    JOIN(A, insert)(self, value);
+}
+
+#include <ctl/bits/container.h>
+
+static inline I JOIN(A, end)(A *self)
+{
+    static I zero;
+    I iter = zero;
+    iter.container = self;
+    iter.index = JOIN(A, bucket_count)(self);
+    iter.vtable.next = JOIN(I, next);
+    iter.vtable.ref = JOIN(I, ref);
+    iter.vtable.done = JOIN(I, done);
+    return iter;
+}
+
+static inline I JOIN(I, iter)(A *self, size_t index)
+{
+    I iter = JOIN(A, end)(self);
+    if (self->ctrl && index <= self->bucket_max)
+    {
+        iter.index = index;
+        iter.ref = &self->slots[index];
+    }
+    return iter;
+}
+
+static inline I JOIN(A, begin)(A *self)
+{
+    if (!self->size)
+        return JOIN(A, end)(self);
+    return JOIN(I, iter)(self, JOIN(A, _next_full)(self, 0));
+}
+
+static inline void JOIN(A, max_load_factor)(A *self, float f)
+{
+    self->max_load_factor = f;
+    if (self->ctrl)
+    {
+        // keep an EMPTY slot to end the probes, also for f >= 1
+        self->growth_limit = (size_t)((self->bucket_max + 1) * f);
+        if (self->growth_limit > self->bucket_max)
+            self->growth_limit = self->bucket_max;
+    }
+}
+
+static inline float JOIN(A, load_factor)(A *self)
+{
+    return self->ctrl ? (float)self->size / (float)(self->bucket_max + 1) : 0.0f;
+}
+
+static inline size_t JOIN(A, __next_power2)(size_t n)
+{
+    size_t p = CTL_SWISS_GROUP_WIDTH;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+// the slot count needed for n elements
+static inline size_t JOIN(A, _capacity_for)(A *self, size_t n)
+{
+    return JOIN(A, __next_power2)((size_t)((double)n / self->max_load_factor) + 1);
+}
+
+// first EMPTY or DELETED slot in the probe sequence of hash
+static inline size_t JOIN(A, _find_non_full)(A *self, size_t hash)
+{
+    size_t pos = JOIN(A, _h1)(self, hash);
+    size_t step = 0;
+    for (;;)
+    {
+        uint32_t m = _ctl_swiss_match_empty_or_deleted(&self->ctrl[pos]);
+        if (m)
+            return (pos + _ctl_swiss_ctz(m)) & self->bucket_max;
+        step += CTL_SWISS_GROUP_WIDTH;
+        pos = (pos + step) & self->bucket_max;
+    }
+}
+
+// new_size must be a power of 2. Also used to drop the tombstones.
+static inline void JOIN(A, _resize)(A *self, size_t new_size)
+{
+    A old = *self;
+    const size_t ctrl_size = new_size + CTL_SWISS_GROUP_WIDTH;
+    ASSERT(new_size >= CTL_SWISS_GROUP_WIDTH && (new_size & (new_size - 1)) == 0);
+    self->ctrl = (int8_t *)malloc(ctrl_size);
+    self->slots = (T *)malloc(new_size * sizeof(T));
+    ASSERT(self->ctrl && self->slots && "out of memory");
+    memset(self->ctrl, CTL_SWISS_EMPTY, ctrl_size);
+    self->bucket_max = new_size - 1;
+    self->deleted = 0;
+    JOIN(A, max_load_factor)(self, self->max_load_factor);
+    if (old.ctrl)
+    {
+        if (old.size)
+            for (size_t i = JOIN(A, _next_full)(&old, 0); i <= old.bucket_max;
+                 i = JOIN(A, _next_full)(&old, i + 1))
+            {
+                const size_t hash = JOIN(A, _hash)(self, &old.slots[i]);
+                const size_t j = JOIN(A, _find_non_full)(self, hash);
+                JOIN(A, _set_ctrl)(self, j, JOIN(A, _h2)(hash));
+                memcpy(&self->slots[j], &old.slots[i], sizeof(T));
+            }
+        free(old.ctrl);
+        free(old.slots);
+    }
+}
+
+static inline void JOIN(A, reserve)(A *self, size_t desired_count)
+{
+    if (desired_count == 0 || desired_count > JOIN(A, max_size)())
+        return;
+    const size_t new_size = JOIN(A, _capacity_for)(self, desired_count);
+    if (new_size > JOIN(A, bucket_count)(self))
+        JOIN(A, _resize)(self, new_size);
+}
+
+// we do allow shrink here, but not below the size
+static inline void JOIN(A, rehash)(A *self, size_t desired_count)
+{
+    size_t new_size = JOIN(A, __next_power2)(desired_count);
+    const size_t min_size = JOIN(A, _capacity_for)(self, self->size);
+    if (new_size < min_size)
+        new_size = min_size;
+    if (new_size == JOIN(A, bucket_count)(self))
+        return;
+    JOIN(A, _resize)(self, new_size);
+}
+
+static inline A JOIN(A, init)(size_t (*_hash)(T *), int (*_equal)(T *, T *))
+{
+    static A zero;
+    A self = zero;
+    self.hash = _hash;
+    self.equal = _equal;
+#ifdef POD
+    self.copy = JOIN(A, implicit_copy);
+    _JOIN(A, _set_default_methods)(&self);
+#else
+    self.free = JOIN(T, free);
+    self.copy = JOIN(T, copy);
+#endif
+    self.max_load_factor = CTL_SWISS_MAX_LOAD_FACTOR;
+    // the tables are allocated lazily, on the first insert
+    return self;
+}
+
+static inline A JOIN(A, init_from)(A *copy)
+{
+    static A zero;
+    A self = zero;
+#ifdef POD
+    self.copy = JOIN(A, implicit_copy);
+#else
+    self.free = JOIN(T, free);
+    self.copy = JOIN(T, copy);
+#endif
+    self.hash = copy->hash;
+    self.equal = copy->equal;
+    self.max_load_factor = copy->max_load_factor;
+    return self;
+}
+
+// Note: As this is used internally a lot, don't consume (free) the key.
+// Returns the slot index, or SIZE_MAX if not found.
+static inline size_t JOIN(A, _find_hash)(A *self, T *value, size_t hash)
+{
+    const int8_t h2 = JOIN(A, _h2)(hash);
+    size_t pos = JOIN(A, _h1)(self, hash);
+    size_t step = 0;
+    for (;;)
+    {
+        const int8_t *g = &self->ctrl[pos];
+        for (uint32_t m = _ctl_swiss_match(g, h2); m; m &= m - 1)
+        {
+            const size_t i = (pos + _ctl_swiss_ctz(m)) & self->bucket_max;
+            if (self->equal(value, &self->slots[i]))
+                return i;
+        }
+        if (_ctl_swiss_match_empty(g))
+            return SIZE_MAX;
+        step += CTL_SWISS_GROUP_WIDTH;
+        // triangular probing visits all groups once
+        if (step > self->bucket_max)
+            return SIZE_MAX;
+        pos = (pos + step) & self->bucket_max;
+    }
+}
+
+static inline size_t JOIN(A, _find_index)(A *self, T *value)
+{
+    if (!self->size)
+        return SIZE_MAX;
+    return JOIN(A, _find_hash)(self, value, JOIN(A, _hash)(self, value));
+}
+
+static inline T *JOIN(A, find_ref)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    return i == SIZE_MAX ? NULL : &self->slots[i];
+}
+
+static inline I JOIN(A, find)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    if (i == SIZE_MAX)
+        return JOIN(A, end)(self);
+    return JOIN(I, iter)(self, i);
+}
+
+// the growth policy before insert: double, or just drop the tombstones
+static inline void JOIN(A, _pre_insert_grow)(A *self)
+{
+    if (!self->ctrl)
+        JOIN(A, _resize)(self, CTL_SWISS_GROUP_WIDTH);
+    else if (self->size + self->deleted + 1 > self->growth_limit)
+    {
+        const size_t cap = self->bucket_max + 1;
+        if (self->size + 1 <= self->growth_limit / 2)
+            JOIN(A, _resize)(self, cap);
+        else
+            JOIN(A, _resize)(self, cap * 2);
+    }
+}
+
+// value must not exist yet
+static inline size_t JOIN(A, _insert_hash)(A *self, T *value, size_t hash)
+{
+    JOIN(A, _pre_insert_grow)(self);
+    const size_t i = JOIN(A, _find_non_full)(self, hash);
+    if (self->ctrl[i] == CTL_SWISS_DELETED)
+        self->deleted--;
+    JOIN(A, _set_ctrl)(self, i, JOIN(A, _h2)(hash));
+    memcpy(&self->slots[i], value, sizeof(T));
+    self->size++;
+    return i;
+}
+
+static inline I JOIN(A, emplace_found)(A *self, T *value, int *foundp)
+{
+    const size_t hash = JOIN(A, _hash)(self, value);
+    size_t i;
+    if (self->size && (i = JOIN(A, _find_hash)(self, value, hash)) != SIZE_MAX)
+    {
+        FREE_VALUE(self, *value);
+        *foundp = 1;
+        return JOIN(I, iter)(self, i);
+    }
+    *foundp = 0;
+    return JOIN(I, iter)(self, JOIN(A, _insert_hash)(self, value, hash));
+}
+
+static inline I JOIN(A, emplace)(A *self, T *value)
+{
+    int found;
+    return JOIN(A, emplace_found)(self, value, &found);
+}
+
+// the position makes no sense with open addressing
+static inline I JOIN(A, emplace_hint)(I *pos, T *value)
+{
+    return JOIN(A, emplace)(pos->container, value);
+}
+
+static inline I JOIN(A, insert_found)(A *self, T value, int *foundp)
+{
+    return JOIN(A, emplace_found)(self, &value, foundp);
+}
+
+static inline void JOIN(A, insert)(A *self, T value)
+{
+    int found;
+    JOIN(A, emplace_found)(self, &value, &found);
+}
+
+static inline size_t JOIN(A, count)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    FREE_VALUE(self, value);
+    return i == SIZE_MAX ? 0UL : 1UL;
+}
+
+// C++20
+static inline bool JOIN(A, contains)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    FREE_VALUE(self, value);
+    return i != SIZE_MAX;
+}
+
+static inline void JOIN(A, _erase_index)(A *self, size_t i)
+{
+    const size_t before = (i - CTL_SWISS_GROUP_WIDTH) & self->bucket_max;
+    const uint32_t empty_after = _ctl_swiss_match_empty(&self->ctrl[i]);
+    const uint32_t empty_before = _ctl_swiss_match_empty(&self->ctrl[before]);
+    // If no full group window ever covered this slot, no probe sequence went
+    // past it, and it can be EMPTY again. Else leave a tombstone.
+    const bool was_never_full = empty_before && empty_after &&
+        _ctl_swiss_ctz(empty_after) + _ctl_swiss_clz(empty_before) < CTL_SWISS_GROUP_WIDTH;
+#ifndef POD
+    if (self->free)
+        self->free(&self->slots[i]);
+#endif
+    if (was_never_full)
+        JOIN(A, _set_ctrl)(self, i, CTL_SWISS_EMPTY);
+    else
+    {
+        JOIN(A, _set_ctrl)(self, i, CTL_SWISS_DELETED);
+        self->deleted++;
+    }
+    self->size--;
+}
+
+static inline void JOIN(A, erase)(A *self, T value)
+{
+    const size_t i = JOIN(A, _find_index)(self, &value);
+    if (i != SIZE_MAX)
+        JOIN(A, _erase_index)(self, i);
+}
+
+// advances pos to the next element
+static inline void JOIN(A, erase_it)(I *pos)
+{
+    if (!JOIN(I, done)(pos))
+    {
+        JOIN(A, _erase_index)(pos->container, pos->index);
+        JOIN(I, next)(pos);
+    }
+}
+
+static inline size_t JOIN(A, erase_if)(A *self, int (*_match)(T *))
+{
+    size_t erases = 0;
+    if (!self->size)
+        return 0;
+    for (size_t i = JOIN(A, _next_full)(self, 0); i <= self->bucket_max; i = JOIN(A, _next_full)(self, i + 1))
+    {
+        if (_match(&self->slots[i]))
+        {
+            JOIN(A, _erase_index)(self, i);
+            erases += 1;
+        }
+    }
+    return erases;
+}
+
+static inline void JOIN(A, clear)(A *self)
+{
+    if (LIKELY(self->ctrl))
+    {
+#ifndef POD
+        if (self->free && self->size)
+            for (size_t i = JOIN(A, _next_full)(self, 0); i <= self->bucket_max;
+                 i = JOIN(A, _next_full)(self, i + 1))
+                self->free(&self->slots[i]);
+#endif
+        memset(self->ctrl, CTL_SWISS_EMPTY, self->bucket_max + 1 + CTL_SWISS_GROUP_WIDTH);
+    }
+    self->size = 0;
+    self->deleted = 0;
+}
+
+static inline void JOIN(A, free)(A *self)
+{
+    JOIN(A, clear)(self);
+    free(self->ctrl);
+    free(self->slots);
+    self->ctrl = NULL;
+    self->slots = NULL;
+    self->bucket_max = 0;
+    self->growth_limit = 0;
+}
+
+// Same hash, same layout. No need to rehash.
+static inline A JOIN(A, copy)(A *self)
+{
+    A other = JOIN(A, init_from)(self);
+    if (!self->ctrl)
+        return other;
+    const size_t cap = self->bucket_max + 1;
+    other.ctrl = (int8_t *)malloc(cap + CTL_SWISS_GROUP_WIDTH);
+    other.slots = (T *)malloc(cap * sizeof(T));
+    ASSERT(other.ctrl && other.slots && "out of memory");
+    memcpy(other.ctrl, self->ctrl, cap + CTL_SWISS_GROUP_WIDTH);
+#ifdef POD
+    memcpy(other.slots, self->slots, cap * sizeof(T));
+#else
+    if (self->size)
+        for (size_t i = JOIN(A, _next_full)(self, 0); i < cap; i = JOIN(A, _next_full)(self, i + 1))
+            other.slots[i] = self->copy(&self->slots[i]);
+#endif
+    other.size = self->size;
+    other.bucket_max = self->bucket_max;
+    other.deleted = self->deleted;
+    other.growth_limit = self->growth_limit;
+    return other;
+}
+
+static inline void JOIN(A, insert_generic)(A *self, GI *range)
+{
+    void (*next)(struct I *) = range->vtable.next;
+    T *(*ref)(struct I *) = range->vtable.ref;
+    int (*done)(struct I *) = range->vtable.done;
+
+    while (!done(range))
+    {
+        JOIN(A, insert)(self, self->copy(ref(range)));
+        next(range);
+    }
+}
+
+static inline void JOIN(A, erase_generic)(A *self, GI *range)
+{
+    void (*next)(struct I *) = range->vtable.next;
+    T *(*ref)(struct I *) = range->vtable.ref;
+    int (*done)(struct I *) = range->vtable.done;
+
+    while (!done(range))
+    {
+        JOIN(A, erase)(self, *ref(range));
+        next(range);
+    }
+}
+
+static inline A JOIN(A, union)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    JOIN(A, reserve)(&self, a->size + b->size);
+    foreach (A, a, it1)
+        JOIN(A, insert)(&self, self.copy(it1.ref));
+    foreach (A, b, it2)
+        JOIN(A, insert)(&self, self.copy(it2.ref));
+    return self;
+}
+
+static inline A JOIN(A, intersection)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) != SIZE_MAX)
+            JOIN(A, insert)(&self, self.copy(it.ref));
+    return self;
+}
+
+static inline A JOIN(A, difference)(A *a, A *b)
+{
+    A self = JOIN(A, init_from)(a);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) == SIZE_MAX)
+            JOIN(A, insert)(&self, self.copy(it.ref));
+    return self;
+}
+
+static inline A JOIN(A, symmetric_difference)(A *a, A *b)
+{
+    A self = JOIN(A, union)(a, b);
+    foreach (A, a, it)
+        if (JOIN(A, _find_index)(b, it.ref) != SIZE_MAX)
+            JOIN(A, erase)(&self, *it.ref);
+    return self;
+}
+
+// different to the shared equal
+static inline int JOIN(A, equal)(A *self, A *other)
+{
+    if (self->size != other->size)
+        return 0;
+    foreach (A, self, it)
+        if (JOIN(A, _find_index)(other, it.ref) == SIZE_MAX)
+            return 0;
+    return 1;
+}
+
+static inline void JOIN(A, swap)(A *self, A *other)
+{
+    A temp = *self;
+    *self = *other;
+    *other = temp;
+}
+
+// i.e. insert_range
+static inline A JOIN(A, merge_range)(I *r1, GI *r2)
+{
+    A self = JOIN(A, copy)(r1->container);
+    void (*next2)(struct I *) = r2->vtable.next;
+    T *(*ref2)(struct I *) = r2->vtable.ref;
+    int (*done2)(struct I *) = r2->vtable.done;
+
+    while (!done2(r2))
+    {
+        JOIN(A, inserter)(&self, self.copy(ref2(r2)));
+        next2(r2);
+    }
+    return self;
+}
+
+static inline A JOIN(A, merge)(A *self, A *other)
+{
+    return JOIN(A, union)(self, other);
+}
+
+// This one changes in place.
+static inline void JOIN(A, generate)(A *self, T _gen(void))
+{
+    size_t size = self->size;
+    JOIN(A, clear)(self);
+    for (size_t i = 0; i < size; i++)
+        JOIN(A, inserter)(self, _gen());
+}
+
+// We shrink to n, as uset.
+static inline void JOIN(A, generate_n)(A *self, size_t n, T _gen(void))
+{
+    JOIN(A, clear)(self);
+    for (size_t i = 0; i < n; i++)
+        JOIN(A, insert)(self, _gen());
+}
+
+// non-destructive, returns a copy
+static inline A JOIN(A, transform)(A *self, T _unop(T *))
+{
+    A other = JOIN(A, init_from)(self);
+    foreach (A, self, it)
+    {
+        T copy = self->copy(it.ref);
+        T tmp = _unop(&copy);
+        JOIN(A, insert)(&other, tmp);
+        if (self->free)
+            self->free(&copy);
+    }
+    return other;
+}
+
+#undef POD
+#undef COMPARE
+#undef EQUAL
+#undef A
+#undef I
+#undef GI
+#undef T
+#undef CTL_USET
+#undef CTL_SWISS
+
+#ifdef USE_INTERNAL_VERIFY
+#undef USE_INTERNAL_VERIFY
+#endif
@@ -53,6 +53,11 @@ static inline I JOIN(A, insert_or_assign_found)(A *self, T value, int *foundp)
 #undef CTL_UMAP
 #undef uset
 #undef T
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef A
 #undef B
 #undef I
@@ -17,9 +17,35 @@ Growth policies:
 - CTL_USET_CACHED_HASH:      store the hash in the bucket. faster find when
                              unsuccesful (eg on high load factor), but needs a bit more space.
 
+- CTL_USET_FASTRANGE:        with CTL_USET_GROWTH_PRIMED map the mixed hash
+                             by a multiply-shift (fastrange64) to the bucket,
+                             not by the 64-bit modulo.
+
 - CTL_USET_GROWTH_FACTOR defaults to 2.0 for CTL_USET_GROWTH_POWER2 and
 `1.618` for CTL_USET_GROWTH_PRIMED.
 
+- CTL_USET_NODE_POOL:        allocate the nodes in chunks per container, recycle
+                             erased nodes via a freelist, and free all nodes at
+                             once. Chunks grow up to CTL_USET_NODE_POOL_MAX nodes.
+
+- CTL_USET_INCREMENTAL_REHASH: on growth keep the old buckets next to the new,
+                             and move only CTL_USET_REHASH_STEP old buckets per
+                             insert. Avoids the latency spike of moving all
+                             nodes at once, but lookups check both tables
+                             until the move is done.
+
+- CTL_USET_SEEDED:           mix a per container seed into the hash, which
+                             defaults to CTL_USET_SEED `rand()`, and can be set
+                             with seed() before the first insert.
+
+- CTL_USET_BATCH:            number of keys hashed and prefetched at once by
+                             find_batch and contains_batch. Defaults to 16.
+
+- CTL_USET_BUCKET_BITMAP:    keep a bit per used bucket, and skip the empty
+                             buckets 64 at a time when iterating, clearing or
+                             rehashing. Iteration is then O(size) rather than
+                             O(bucket_count), for sparse tables after erases.
+
 Security policies against DDOS attacks, overflowing the chained list:
 
 A seeded hash might need a 2nd hash arg (esp. with threads), but random hash
@@ -32,6 +58,12 @@ seeds are only security theatre.
   4: collision counting with change to sorted vector `CTL_USET_SECURITY_COLLCOUNTING 4`
   5: collision counting with change to tree (as in java) `CTL_USET_SECURITY_COLLCOUNTING 5`
 
+1, 4 and 5 need the compare method (2-way operator<), which defaults to < for
+integral types. The bucket chain is kept, and additionally indexed by a sorted
+vector or a ctl/set.h tree of its nodes, so lookups in the bucket are O(log n).
+1 indexes every bucket with a collision, 4 and 5 only buckets with more than
+128 collisions. The indices are dropped on rehash.
+
 Planned:
 - CTL_USET_MOVE_TO_FRONT moves a bucket in a chain not at the top
 position to the top in each access, such as find and contains, not only insert.
@@ -59,6 +91,18 @@ position to the top in each access, such as find and contains, not only insert.
 #ifndef CTL_USET_MOVE_TO_FRONT
 #define CTL_USET_MOVE_TO_FRONT 0
 #endif
+#if defined CTL_USET_NODE_POOL && !defined CTL_USET_NODE_POOL_MAX
+#define CTL_USET_NODE_POOL_MAX 65536
+#endif
+#if defined CTL_USET_INCREMENTAL_REHASH && !defined CTL_USET_REHASH_STEP
+#define CTL_USET_REHASH_STEP 8
+#endif
+#if defined CTL_USET_SEEDED && !defined CTL_USET_SEED
+#define CTL_USET_SEED ((size_t)rand())
+#endif
+#ifndef CTL_USET_BATCH
+#define CTL_USET_BATCH 16
+#endif
 #ifndef CTL_USET_SECURITY_COLLCOUNTING // defaults to sleep
 #define CTL_USET_SECURITY_COLLCOUNTING 2
 #endif
@@ -91,6 +135,44 @@ position to the top in each access, such as find and contains, not only insert.
 #include <math.h>
 #endif
 
+#if CTL_USET_SECURITY_COLLCOUNTING == 5 && !defined __CTL_USET_COLL_TREE__
+#define __CTL_USET_COLL_TREE__
+// One tree type for all uset_T's: a node of the bucket and the compare
+// method of its container, casted back to int (*)(T *, T *) by uset_T.
+typedef struct _ctl_uset_coll
+{
+    void *node;
+    int (*compare)(void *, void *);
+} _ctl_uset_coll;
+#pragma push_macro("T")
+#pragma push_macro("POD")
+#pragma push_macro("NOT_INTEGRAL")
+#pragma push_macro("HOLD")
+#pragma push_macro("INCLUDE_ALGORITHM")
+// the shared trees use malloc, not the hooks of the first uset
+#pragma push_macro("CTL_ALLOC")
+#pragma push_macro("CTL_REALLOC")
+#pragma push_macro("CTL_FREE")
+#undef T
+#undef HOLD
+#undef INCLUDE_ALGORITHM
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#define T _ctl_uset_coll
+#define POD
+#define NOT_INTEGRAL
+#include <ctl/set.h>
+#pragma pop_macro("CTL_FREE")
+#pragma pop_macro("CTL_REALLOC")
+#pragma pop_macro("CTL_ALLOC")
+#pragma pop_macro("INCLUDE_ALGORITHM")
+#pragma pop_macro("HOLD")
+#pragma pop_macro("NOT_INTEGRAL")
+#pragma pop_macro("POD")
+#pragma pop_macro("T")
+#endif
+
 #define CTL_USET
 #define A JOIN(uset, T)
 #define B JOIN(A, node)
@@ -98,6 +180,8 @@ position to the top in each access, such as find and contains, not only insert.
 #define GI JOIN(A, it)
 
 #include <ctl/ctl.h>
+#include <ctl/bits/alloc.h>
+#include <ctl/bits/hash.h>
 
 typedef struct B
 {
@@ -108,6 +192,27 @@ typedef struct B
 #endif
 } B;
 
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+// the nodes of a long bucket chain, sorted by compare
+typedef struct JOIN(A, svec)
+{
+    B **nodes;
+    size_t size;
+    size_t capacity;
+} JOIN(A, svec);
+#endif
+
+#ifdef CTL_USET_NODE_POOL
+typedef struct JOIN(A, pool)
+{
+    B *chunks;   // linked via the first node of each chunk
+    B *freelist; // erased nodes
+    B *next;     // the unused rest of the current chunk
+    B *end;
+    size_t chunk_size;
+} JOIN(A, pool);
+#endif
+
 typedef struct A
 {
     B **buckets;
@@ -120,10 +225,28 @@ typedef struct A
     T (*copy)(T *);
     size_t (*hash)(T *);
     int (*equal)(T *, T *);
-#if CTL_USET_SECURITY_COLLCOUNTING == 4
-    bool is_sorted_vector;
+#ifdef CTL_USET_NODE_POOL
+    JOIN(A, pool) pool;
+#endif
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    B **old_buckets;       // not yet migrated, or NULL
+    size_t old_bucket_max;
+    size_t migrate_pos;    // old_buckets below are already moved
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+    JOIN(A, svec) *sorted; // per bucket, or NULL until the first change
 #elif CTL_USET_SECURITY_COLLCOUNTING == 5
-    bool is_map;
+    set__ctl_uset_coll **trees; // per bucket, or NULL until the first change
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    int (*compare)(T *, T *); // 2-way operator<, for the long chains
+#endif
+#ifdef CTL_USET_SEEDED
+    size_t seed;
+#endif
+#ifdef CTL_USET_BUCKET_BITMAP
+    uint64_t *used; // a bit per non-empty bucket
 #endif
 } A;
 
@@ -141,28 +264,130 @@ static inline size_t JOIN(A, bucket_count)(A *self)
     return self->buckets ? self->bucket_max + 1 : 0;
 }
 
-static inline size_t JOIN(I, index)(A *self, T value)
+#ifdef CTL_USET_BUCKET_BITMAP
+#ifndef __CTL_USET_BITMAP__
+#define __CTL_USET_BITMAP__
+static inline unsigned _ctl_uset_ctz64(uint64_t m)
 {
-#ifdef CTL_USET_GROWTH_POWER2
-    return self->hash(&value) & self->bucket_max;
-#elif __WORDSIZE == 127
-    return ((uint64_t) self->hash(&value) * ((uint64_t) self->bucket_max + 1)) >> 32;
+#ifdef __GNUC__
+    return __builtin_ctzll(m);
 #else
-    return self->hash(&value) % (self->bucket_max + 1);
+    unsigned n = 0;
+    while (!(m & 1))
+    {
+        m >>= 1;
+        n++;
+    }
+    return n;
 #endif
 }
 
-#ifdef CTL_USET_CACHED_HASH
-static inline size_t JOIN(I, cached_index)(A *self, B *node)
+static inline size_t _ctl_uset_bitmap_words(size_t bucket_count)
+{
+    return (bucket_count + 63) / 64;
+}
+#endif
+
+static inline void JOIN(A, _mark)(A *self, B **b)
+{
+    const size_t i = b - self->buckets;
+    self->used[i / 64] |= UINT64_C(1) << (i % 64);
+}
+
+// b must be in the current buckets, not the old ones
+static inline void JOIN(A, _unmark)(A *self, B **b)
+{
+    const size_t i = b - self->buckets;
+    self->used[i / 64] &= ~(UINT64_C(1) << (i % 64));
+}
+
+// the index of the first used bucket from i on, or bucket_max + 1.
+static inline size_t JOIN(A, _next_used)(A *self, size_t i)
+{
+    const size_t count = self->bucket_max + 1;
+    if (i >= count)
+        return count;
+    const size_t words = _ctl_uset_bitmap_words(count);
+    size_t w = i / 64;
+    uint64_t m = self->used[w] & (~UINT64_C(0) << (i % 64));
+    while (!m)
+    {
+        if (++w == words)
+            return count;
+        m = self->used[w];
+    }
+    return w * 64 + _ctl_uset_ctz64(m);
+}
+#endif
+
+static inline size_t JOIN(A, _hash)(A *self, T *value)
+{
+#ifdef CTL_USET_SEEDED
+    return (size_t)ctl_hash_mix((uint64_t)self->hash(value) ^ self->seed, CTL_HASH_P1);
+#else
+    return self->hash(value);
+#endif
+}
+
+#ifdef CTL_USET_INCREMENTAL_REHASH
+static inline bool JOIN(A, _is_old_bucket)(A *self, B **b)
+{
+    return self->old_buckets &&
+           (uintptr_t)b - (uintptr_t)self->old_buckets <= self->old_bucket_max * sizeof(B *);
+}
+
+// the next used bucket after b, first in the new then in the not yet migrated
+// old buckets. NULL at the end.
+static inline B **JOIN(A, _next_bucket)(A *self, B **b)
+{
+    size_t i;
+    if (JOIN(A, _is_old_bucket)(self, b))
+        i = b - self->old_buckets + 1;
+    else
+    {
+#ifdef CTL_USET_BUCKET_BITMAP
+        i = JOIN(A, _next_used)(self, b - self->buckets + 1);
+        if (i <= self->bucket_max)
+            return &self->buckets[i];
+#else
+        for (i = b - self->buckets + 1; i <= self->bucket_max; i++)
+            if (self->buckets[i])
+                return &self->buckets[i];
+#endif
+        if (!self->old_buckets)
+            return NULL;
+        i = self->migrate_pos;
+    }
+    for (; i <= self->old_bucket_max; i++)
+        if (self->old_buckets[i])
+            return &self->old_buckets[i];
+    return NULL;
+}
+#endif
+
+// the bucket index of the hash, for all 64 bits of size_t
+static inline size_t JOIN(A, _reduce)(size_t hash, size_t bucket_max)
 {
 #ifdef CTL_USET_GROWTH_POWER2
-    return node->cached_hash & self->bucket_max;
-#elif __WORDSIZE == 127
-    return ((uint64_t) node->cached_hash * ((uint64_t) self->bucket_max + 1)) >> 32;
+    return hash & bucket_max;
+#elif defined CTL_USET_FASTRANGE
+    // mix the low bits of weak hashes up, still faster than the division
+    return ctl_fastrange(ctl_hash_int(hash), bucket_max + 1);
 #else
-    return node->cached_hash % (self->bucket_max + 1);
+    return hash % (bucket_max + 1);
 #endif
 }
+
+static inline size_t JOIN(I, index)(A *self, T value)
+{
+    return JOIN(A, _reduce)(JOIN(A, _hash)(self, &value), self->bucket_max);
+}
+
+#ifdef CTL_USET_CACHED_HASH
+static inline size_t JOIN(I, cached_index)(A *self, B *node)
+{
+    return JOIN(A, _reduce)(node->cached_hash, self->bucket_max);
+}
 #define BUCKET_INDEX(iter) JOIN(I, cached_index)((iter)->container, (iter)->node)
 
 #else
@@ -172,6 +397,9 @@ static inline size_t JOIN(I, cached_index)(A *self, B *node)
 static inline I JOIN(I, iter)(A *self, B *node);
 static inline I JOIN(A, begin)(A *self);
 static inline I JOIN(A, end)(A *self);
+#ifdef CTL_USET_INCREMENTAL_REHASH
+static inline B **JOIN(A, _node_bucket)(A *self, B *node);
+#endif
 
 static inline T *JOIN(I, ref)(I *iter)
 {
@@ -188,7 +416,9 @@ static inline void JOIN(I, update)(I *iter)
 {
     ASSERT(iter);
     ASSERT(iter->node);
+#ifndef CTL_USET_INCREMENTAL_REHASH
     ASSERT(iter->buckets - iter->container->buckets <= (long)iter->container->bucket_max);
+#endif
     iter->ref = &iter->node->value;
     //iter->next = iter->node->next;
 }
@@ -203,6 +433,36 @@ static inline void JOIN(I, next)(I *iter)
     if (!iter->node->next)
     {
         A *self = iter->container;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+        if (self->old_buckets)
+        {
+            B **b = JOIN(A, _next_bucket)(self, iter->buckets);
+            iter->node = b ? *b : NULL;
+            if (b)
+            {
+                iter->buckets = b;
+                JOIN(I, update)(iter);
+            }
+            return;
+        }
+#endif
+#ifdef CTL_USET_BUCKET_BITMAP
+        // the bitmap lookup is a dependent load per step, slower than the
+        // plain scan over a few empty buckets
+        if (self->size < self->bucket_max / 8)
+        {
+            const size_t i = JOIN(A, _next_used)(self, iter->buckets - self->buckets + 1);
+            if (i <= self->bucket_max)
+            {
+                iter->buckets = &self->buckets[i];
+                iter->node = *iter->buckets;
+                JOIN(I, update)(iter);
+                return;
+            }
+            iter->node = NULL;
+            return;
+        }
+#endif
         B **b_last = &self->buckets[self->bucket_max];
         for (B **b = ++iter->buckets; b <= b_last; b++)
         {
@@ -285,9 +545,20 @@ static inline B *JOIN(B, next)(A *container, B *node)
 {
     if (node->next)
         return node->next;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    else if (container->old_buckets)
+    {
+        B **b = JOIN(A, _next_bucket)(container, JOIN(A, _node_bucket)(container, node));
+        return b ? *b : NULL;
+    }
+#endif
     else
     {
         size_t i = JOIN(I, index)(container, node->value) + 1;
+#ifdef CTL_USET_BUCKET_BITMAP
+        i = JOIN(A, _next_used)(container, i);
+        return i <= container->bucket_max ? container->buckets[i] : NULL;
+#else
         for (; i <= container->bucket_max; i++)
         {
             B *n = container->buckets[i];
@@ -295,6 +566,7 @@ static inline B *JOIN(B, next)(A *container, B *node)
                 return n;
         }
         return NULL;
+#endif
     }
 }
 /*
@@ -347,6 +619,28 @@ static inline I JOIN(A, begin)(A *self)
     iter.vtable.next = JOIN(I, next);
     iter.vtable.ref = JOIN(I, ref);
     iter.vtable.done = JOIN(I, done);
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (self->old_buckets)
+    {
+        B **b = *self->buckets ? self->buckets : JOIN(A, _next_bucket)(self, self->buckets);
+        if (b)
+        {
+            iter.ref = &(*b)->value;
+            iter.node = *b;
+            iter.buckets = b;
+        }
+        return iter;
+    }
+#endif
+#ifdef CTL_USET_BUCKET_BITMAP
+    const size_t i = JOIN(A, _next_used)(self, 0);
+    if (i <= self->bucket_max)
+    {
+        iter.buckets = &self->buckets[i];
+        iter.node = *iter.buckets;
+        iter.ref = &iter.node->value;
+    }
+#else
     B **b_last = &self->buckets[self->bucket_max];
     for (B **b = self->buckets; b <= b_last; b++)
     {
@@ -360,6 +654,7 @@ static inline I JOIN(A, begin)(A *self)
             return iter;
         }
     }
+#endif
     return iter;
 }
 
@@ -390,13 +685,18 @@ static inline I JOIN(I, iter)(A *self, B *node)
     iter.vtable.next = JOIN(I, next);
     iter.vtable.ref = JOIN(I, ref);
     iter.vtable.done = JOIN(I, done);
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (node)
+        iter.buckets = JOIN(A, _node_bucket)(self, node);
+#else
     iter.buckets = &self->buckets[BUCKET_INDEX(&iter)];
+#endif
     return iter;
 }
 
 static inline size_t JOIN(A, __next_prime)(size_t number)
 {
-    static const uint32_t primes[] = {
+    static const size_t primes[] = {
         2,         3,         5,         7,          11,         13,         17,         19,         23,
         29,        31,        37,        41,         43,         47,         53,         59,         61,
         67,        71,        73,        79,         83,         89,         97,         103,        109,
@@ -424,7 +724,22 @@ static inline size_t JOIN(A, __next_prime)(size_t number)
         206062531, 222936881, 241193053, 260944219,  282312799,  305431229,  330442829,  357502601,  386778277,
         418451333, 452718089, 489790921, 529899637,  573292817,  620239453,  671030513,  725980837,  785430967,
         849749479, 919334987, 994618837, 1076067617, 1164186217, 1259520799, 1362662261, 1474249943, 1594975441,
-        1725587117};
+        1725587117,
+#if SIZE_MAX > UINT32_MAX
+        1867085287, 2020186283, 2185841561, 2365080577, 2559017203, 2768856617, 2995902863,
+        3241566917, 3507375407, 3794980237, 4106168617, 4442874451, 4807190159, 5201379769,
+        5627892913, 6089380139, 6588709331, 7128983509, 7713560159, 8346072101, 9030450061,
+        9770947019, 10572164677, 11439082189, 12377086937, 13392008081, 14490152797, 15678345337,
+        16963969657, 18355015169, 19860126439, 21488656811, 23250726691, 25157286293, 27220183829,
+        29452238939, 31867322551, 34480443013, 37307839357, 40367082191, 43677182933, 47258711977,
+        51133926373, 55326908347, 59863714861, 64772539501, 70083887747, 75830766547, 82048889413,
+        88776898349, 96056604023, 103933245587, 112455771767, 121677145081, 131654670991, 142450354091,
+        154131283147, 166770048371, 180445192349, 195241698133, 211251517397, 228574141837, 247317221507,
+        267597233713, 289540206911, 313282503893, 338971669213, 366767346091, 396842268481, 429383334533,
+        464592767981, 502689374969, 543909903749, 588510515893, 636768378199, 688983385213, 745480022809,
+        806609384683, 872751354259, 944316965357, 1021750956521, 1105534534969
+#endif
+    };
     size_t min = primes[0];
     if (number < min)
         return min;
@@ -440,20 +755,28 @@ static inline size_t JOIN(A, __next_prime)(size_t number)
 }
 
 #ifdef CTL_USET_GROWTH_POWER2
-// Support huge hash tables with wordsize 64? currently we have a 32bit max_size
-static inline uint32_t JOIN(A, __next_power2)(uint32_t n)
+static inline size_t JOIN(A, __next_power2)(size_t n)
 {
+    if (n <= 8)
+        return 8;
 #ifdef __GNUC__
-    return n >= 8 ? 1 << (32 - __builtin_clz(n - 1)) : 8;
+#if SIZE_MAX > UINT32_MAX
+    return (size_t)1 << (64 - __builtin_clzll((unsigned long long)n - 1));
+#else
+    return (size_t)1 << (32 - __builtin_clz((unsigned)n - 1));
+#endif
 #else
-    return 1 << (uint32_t)ceil(log2((double)n));
+    size_t p = 8;
+    while (p < n)
+        p <<= 1;
+    return p;
 #endif
 }
 #endif
 
 static inline B *JOIN(B, init)(T value)
 {
-    B *n = (B *)malloc(sizeof(B));
+    B *n = (B *)CTL_ALLOC(sizeof(B));
     n->value = value;
     n->next = NULL;
     return n;
@@ -462,7 +785,7 @@ static inline B *JOIN(B, init)(T value)
 #ifdef CTL_USET_CACHED_HASH
 static inline B *JOIN(B, init_cached)(T value, size_t hash)
 {
-    B *n = (B *)malloc(sizeof(B));
+    B *n = (B *)CTL_ALLOC(sizeof(B));
     n->value = value;
     n->cached_hash = hash;
     n->next = NULL;
@@ -470,6 +793,75 @@ static inline B *JOIN(B, init_cached)(T value, size_t hash)
 }
 #endif
 
+#ifdef CTL_USET_NODE_POOL
+static inline B *JOIN(A, _pool_alloc)(A *self)
+{
+    JOIN(A, pool) *pool = &self->pool;
+    B *n = pool->freelist;
+    if (n)
+    {
+        pool->freelist = n->next;
+        return n;
+    }
+    if (pool->next == pool->end)
+    {
+        size_t chunk_size = pool->chunk_size ? pool->chunk_size * 2 : 32;
+        if (chunk_size > CTL_USET_NODE_POOL_MAX)
+            chunk_size = CTL_USET_NODE_POOL_MAX;
+        B *chunk = (B *)CTL_ALLOC(chunk_size * sizeof(B));
+        ASSERT(chunk && "out of memory");
+        // the first node is the link to the previous chunk
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->next = &chunk[1];
+        pool->end = &chunk[chunk_size];
+        pool->chunk_size = chunk_size;
+    }
+    return pool->next++;
+}
+
+// frees all nodes at once, but not their values
+static inline void JOIN(A, _pool_free)(A *self)
+{
+    static JOIN(A, pool) zero;
+    B *chunk = self->pool.chunks;
+    while (chunk)
+    {
+        B *next = chunk->next;
+        CTL_FREE(chunk);
+        chunk = next;
+    }
+    self->pool = zero;
+}
+#endif
+
+static inline B *JOIN(A, _node_init)(A *self, T value)
+{
+#ifdef CTL_USET_NODE_POOL
+    B *n = JOIN(A, _pool_alloc)(self);
+    n->value = value;
+    n->next = NULL;
+    return n;
+#else
+    (void)self;
+    return JOIN(B, init)(value);
+#endif
+}
+
+#ifdef CTL_USET_CACHED_HASH
+static inline B *JOIN(A, _node_init_cached)(A *self, T value, size_t hash)
+{
+#ifdef CTL_USET_NODE_POOL
+    B *n = JOIN(A, _node_init)(self, value);
+    n->cached_hash = hash;
+    return n;
+#else
+    (void)self;
+    return JOIN(B, init_cached)(value, hash);
+#endif
+}
+#endif
+
 static inline size_t JOIN(B, bucket_size)(B *self)
 {
     size_t size = 0;
@@ -488,6 +880,17 @@ static inline void JOIN(B, push)(B **bucketp, B *n)
     *bucketp = n;
 }
 
+// push into one of the current buckets
+static inline void JOIN(A, _push)(A *self, B **bucketp, B *n)
+{
+    JOIN(B, push)(bucketp, n);
+#ifdef CTL_USET_BUCKET_BITMAP
+    JOIN(A, _mark)(self, bucketp);
+#else
+    (void)self;
+#endif
+}
+
 static inline B **JOIN(A, _cached_bucket)(A *self, B *node)
 {
 #ifdef CTL_USET_CACHED_HASH
@@ -499,22 +902,13 @@ static inline B **JOIN(A, _cached_bucket)(A *self, B *node)
     return &self->buckets[hash];
 }
 
-#ifdef CTL_USET_CACHED_HASH
-
 static inline B **JOIN(A, _bucket_hash)(A *self, size_t hash)
 {
     //LOG ("buckets %lx %% %lu\n", hash, self->bucket_max);
-#ifdef CTL_USET_GROWTH_POWER2
-    return &self->buckets[hash & self->bucket_max];
-#elif __WORDSIZE == 127
-    return &self->buckets[((uint64_t) hash * (uint64_t) (self->bucket_max + 1)) >> 32];
-#else
-    return &self->buckets[hash % (self->bucket_max + 1)];
-#endif
+    return &self->buckets[JOIN(A, _reduce)(hash, self->bucket_max)];
 }
 
-#else
-
+#ifndef CTL_USET_CACHED_HASH
 static inline B **JOIN(A, _bucket)(A *self, T value)
 {
     const size_t hash = JOIN(I, index)(self, value);
@@ -523,6 +917,98 @@ static inline B **JOIN(A, _bucket)(A *self, T value)
 }
 #endif
 
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+static inline void JOIN(A, _coll_free)(A *self);
+#endif
+
+#ifdef CTL_USET_INCREMENTAL_REHASH
+static inline size_t JOIN(A, _node_hash)(A *self, B *node)
+{
+#ifdef CTL_USET_CACHED_HASH
+    (void)self;
+    return node->cached_hash;
+#else
+    return JOIN(A, _hash)(self, &node->value);
+#endif
+}
+
+// the not yet migrated old bucket for the hash, or NULL
+static inline B **JOIN(A, _old_bucket_hash)(A *self, size_t hash)
+{
+    const size_t i = JOIN(A, _reduce)(hash, self->old_bucket_max);
+    return i >= self->migrate_pos ? &self->old_buckets[i] : NULL;
+}
+
+// the bucket the node is linked in, old or new
+static inline B **JOIN(A, _node_bucket)(A *self, B *node)
+{
+    if (self->old_buckets)
+    {
+        B **old = JOIN(A, _old_bucket_hash)(self, JOIN(A, _node_hash)(self, node));
+        if (old)
+            return old;
+    }
+    return JOIN(A, _cached_bucket)(self, node);
+}
+
+// moves the next count old buckets into the new buckets
+static inline void JOIN(A, _rehash_step)(A *self, size_t count)
+{
+    B **old = self->old_buckets;
+    size_t i = self->migrate_pos;
+    for (; i <= self->old_bucket_max && count; i++, count--)
+    {
+        B *node = old[i];
+        while (node)
+        {
+            B *next = node->next;
+            JOIN(A, _push)(self, JOIN(A, _cached_bucket)(self, node), node);
+            node = next;
+        }
+        old[i] = NULL;
+    }
+    self->migrate_pos = i;
+    if (i > self->old_bucket_max)
+    {
+        CTL_FREE(old);
+        self->old_buckets = NULL;
+        self->old_bucket_max = 0;
+        self->migrate_pos = 0;
+    }
+}
+
+static inline void JOIN(A, _rehash_finish)(A *self)
+{
+    if (self->old_buckets)
+        JOIN(A, _rehash_step)(self, SIZE_MAX);
+}
+
+// count: guaranteed growth policy (power2 or prime).
+// Only swaps in the new buckets, the nodes are moved by later inserts.
+static inline void JOIN(A, _rehash_start)(A *self, size_t count)
+{
+    JOIN(A, _rehash_finish)(self);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(A, _coll_free)(self);
+#endif
+    self->old_buckets = self->buckets;
+    self->old_bucket_max = self->bucket_max;
+    self->migrate_pos = 0;
+    self->buckets = (B **)_CTL_CALLOC(count, sizeof(B *));
+    ASSERT(self->buckets && "out of memory");
+#ifdef CTL_USET_BUCKET_BITMAP
+    // the old buckets are scanned without the bitmap
+    CTL_FREE(self->used);
+    self->used = (uint64_t *)_CTL_CALLOC(_ctl_uset_bitmap_words(count), sizeof(uint64_t));
+    ASSERT(self->used && "out of memory");
+#endif
+    self->bucket_max = count - 1;
+    self->max_bucket_count = count; // as with _rehash
+}
+#endif
+
 static inline size_t JOIN(A, bucket)(A *self, T value)
 {
     const size_t hash = JOIN(I, index)(self, value);
@@ -538,6 +1024,219 @@ static inline size_t JOIN(A, bucket_size)(A *self, size_t index)
     return size;
 }
 
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+
+// the sorted vector of the bucket, or NULL
+static inline JOIN(A, svec) *JOIN(A, _sorted)(A *self, B **buckets)
+{
+    if (!self->sorted)
+        return NULL;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (JOIN(A, _is_old_bucket)(self, buckets))
+        return NULL;
+#endif
+    JOIN(A, svec) *vec = &self->sorted[buckets - self->buckets];
+    return vec->nodes ? vec : NULL;
+}
+
+// index of the first node not less than value
+static inline size_t JOIN(A, _sorted_lower_bound)(A *self, B **nodes, size_t size, T *value)
+{
+    size_t lo = 0;
+    size_t hi = size;
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (self->compare(&nodes[mid]->value, value))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static inline B *JOIN(B, find_sorted_vector)(A *self, B **buckets, T *value)
+{
+    JOIN(A, svec) *vec = JOIN(A, _sorted)(self, buckets);
+    const size_t i = JOIN(A, _sorted_lower_bound)(self, vec->nodes, vec->size, value);
+    if (i < vec->size && self->equal(value, &vec->nodes[i]->value))
+        return vec->nodes[i];
+    return NULL;
+}
+
+static inline void JOIN(A, _sorted_add)(A *self, B **buckets, B *node)
+{
+    JOIN(A, svec) *vec = JOIN(A, _sorted)(self, buckets);
+    const size_t i = JOIN(A, _sorted_lower_bound)(self, vec->nodes, vec->size, &node->value);
+    if (vec->size == vec->capacity)
+    {
+        vec->capacity *= 2;
+        vec->nodes = (B **)CTL_REALLOC(vec->nodes, vec->capacity * sizeof(B *));
+        ASSERT(vec->nodes && "out of memory");
+    }
+    memmove(&vec->nodes[i + 1], &vec->nodes[i], (vec->size - i) * sizeof(B *));
+    vec->nodes[i] = node;
+    vec->size++;
+}
+
+// Index the chain of the bucket by a sorted vector. Not with a pending
+// incremental rehash or without a compare method.
+static inline bool JOIN(B, change_to_sorted_vector)(A *self, B **buckets)
+{
+    if (!self->compare || JOIN(A, _sorted)(self, buckets))
+        return false;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (self->old_buckets)
+        return false;
+#endif
+    if (!self->sorted)
+    {
+        self->sorted = (JOIN(A, svec) *)_CTL_CALLOC(self->bucket_max + 1, sizeof(JOIN(A, svec)));
+        ASSERT(self->sorted && "out of memory");
+    }
+    JOIN(A, svec) *vec = &self->sorted[buckets - self->buckets];
+    const size_t size = JOIN(B, bucket_size)(*buckets);
+    vec->capacity = 8;
+    while (vec->capacity < size)
+        vec->capacity *= 2;
+    vec->nodes = (B **)CTL_ALLOC(vec->capacity * sizeof(B *));
+    ASSERT(vec->nodes && "out of memory");
+    for (B *n = *buckets; n; n = n->next)
+        JOIN(A, _sorted_add)(self, buckets, n);
+    return true;
+}
+
+// after a push into the bucket
+static inline void JOIN(B, insert_sorted_vector)(A *self, B **buckets, B *node)
+{
+    if (JOIN(A, _sorted)(self, buckets))
+        JOIN(A, _sorted_add)(self, buckets, node);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1
+    else if (node->next) // the first collision
+        JOIN(B, change_to_sorted_vector)(self, buckets);
+#endif
+}
+
+// before the node is unlinked from the bucket
+static inline void JOIN(B, erase_sorted_vector)(A *self, B **buckets, B *node)
+{
+    JOIN(A, svec) *vec = JOIN(A, _sorted)(self, buckets);
+    if (!vec)
+        return;
+    size_t i = JOIN(A, _sorted_lower_bound)(self, vec->nodes, vec->size, &node->value);
+    while (vec->nodes[i] != node)
+        i++;
+    vec->size--;
+    memmove(&vec->nodes[i], &vec->nodes[i + 1], (vec->size - i) * sizeof(B *));
+}
+
+// drop all sorted vectors
+static inline void JOIN(A, _coll_free)(A *self)
+{
+    if (!self->sorted)
+        return;
+    for (size_t i = 0; i <= self->bucket_max; i++)
+        CTL_FREE(self->sorted[i].nodes);
+    CTL_FREE(self->sorted);
+    self->sorted = NULL;
+}
+
+#elif CTL_USET_SECURITY_COLLCOUNTING == 5
+
+static inline int JOIN(A, _coll_compare)(_ctl_uset_coll *a, _ctl_uset_coll *b)
+{
+    int (*compare)(T *, T *) = (int (*)(T *, T *))a->compare;
+    return compare(&((B *)a->node)->value, &((B *)b->node)->value);
+}
+
+static inline _ctl_uset_coll JOIN(A, _coll_key)(A *self, B *node)
+{
+    _ctl_uset_coll key;
+    key.node = node;
+    key.compare = (int (*)(void *, void *))self->compare;
+    return key;
+}
+
+// the tree of the bucket, or NULL
+static inline set__ctl_uset_coll *JOIN(A, _tree)(A *self, B **buckets)
+{
+    if (!self->trees)
+        return NULL;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (JOIN(A, _is_old_bucket)(self, buckets))
+        return NULL;
+#endif
+    return self->trees[buckets - self->buckets];
+}
+
+static inline B *JOIN(B, find_map)(A *self, B **buckets, T *value)
+{
+    set__ctl_uset_coll *tree = JOIN(A, _tree)(self, buckets);
+    B probe;
+    probe.value = *value;
+    set__ctl_uset_coll_node *found = set__ctl_uset_coll_find_node(tree, JOIN(A, _coll_key)(self, &probe));
+    if (found && self->equal(value, &((B *)found->value.node)->value))
+        return (B *)found->value.node;
+    return NULL;
+}
+
+// Index the chain of the bucket by a tree. Not with a pending incremental
+// rehash or without a compare method.
+static inline bool JOIN(B, change_to_map)(A *self, B **buckets)
+{
+    if (!self->compare || JOIN(A, _tree)(self, buckets))
+        return false;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (self->old_buckets)
+        return false;
+#endif
+    if (!self->trees)
+    {
+        self->trees = (set__ctl_uset_coll **)_CTL_CALLOC(self->bucket_max + 1, sizeof(set__ctl_uset_coll *));
+        ASSERT(self->trees && "out of memory");
+    }
+    set__ctl_uset_coll *tree = (set__ctl_uset_coll *)CTL_ALLOC(sizeof(set__ctl_uset_coll));
+    ASSERT(tree && "out of memory");
+    *tree = set__ctl_uset_coll_init(JOIN(A, _coll_compare));
+    for (B *n = *buckets; n; n = n->next)
+        set__ctl_uset_coll_insert(tree, JOIN(A, _coll_key)(self, n));
+    self->trees[buckets - self->buckets] = tree;
+    return true;
+}
+
+// after a push into the bucket
+static inline void JOIN(B, insert_map)(A *self, B **buckets, B *node)
+{
+    set__ctl_uset_coll *tree = JOIN(A, _tree)(self, buckets);
+    if (tree)
+        set__ctl_uset_coll_insert(tree, JOIN(A, _coll_key)(self, node));
+}
+
+// before the node is unlinked from the bucket
+static inline void JOIN(B, erase_map)(A *self, B **buckets, B *node)
+{
+    set__ctl_uset_coll *tree = JOIN(A, _tree)(self, buckets);
+    if (tree)
+        set__ctl_uset_coll_erase(tree, JOIN(A, _coll_key)(self, node));
+}
+
+// drop all trees
+static inline void JOIN(A, _coll_free)(A *self)
+{
+    if (!self->trees)
+        return;
+    for (size_t i = 0; i <= self->bucket_max; i++)
+        if (self->trees[i])
+        {
+            set__ctl_uset_coll_free(self->trees[i]);
+            CTL_FREE(self->trees[i]);
+        }
+    CTL_FREE(self->trees);
+    self->trees = NULL;
+}
+
+#endif
+
 static inline void JOIN(A, _free_node)(A *self, B *n)
 {
 #ifndef POD
@@ -547,7 +1246,12 @@ static inline void JOIN(A, _free_node)(A *self, B *n)
 #else
     ASSERT(!self->free || !"uset free with POD");
 #endif
-    free(n);
+#ifdef CTL_USET_NODE_POOL
+    n->next = self->pool.freelist;
+    self->pool.freelist = n;
+#else
+    CTL_FREE(n);
+#endif
     self->size--;
 }
 
@@ -558,7 +1262,7 @@ static inline void JOIN(A, max_load_factor)(A *self, float f)
 
 static inline size_t JOIN(A, max_bucket_count)(A *self)
 {
-    return (size_t)(self->size / self->max_load_factor);
+    return (size_t)((double)self->size / self->max_load_factor);
 }
 
 static inline float JOIN(A, load_factor)(A *self)
@@ -578,15 +1282,25 @@ static inline void JOIN(A, _reserve)(A *self, const size_t new_size)
     if (self->buckets)
     {
         // LOG("_reserve %zu realloc => %zu\n", self->bucket_count, new_size);
-        self->buckets = (B **)realloc(self->buckets, new_size * sizeof(B *));
+        self->buckets = (B **)CTL_REALLOC(self->buckets, new_size * sizeof(B *));
         if (new_size > bucket_count)
             memset(&self->buckets[bucket_count], 0, (new_size - bucket_count) * sizeof(B *));
     }
     else
     {
         // LOG("_reserve %zu calloc => %zu\n", self->bucket_count, new_size);
-        self->buckets = (B **)calloc(new_size, sizeof(B *));
+        self->buckets = (B **)_CTL_CALLOC(new_size, sizeof(B *));
     }
+#ifdef CTL_USET_BUCKET_BITMAP
+    {
+        const size_t words = self->used ? _ctl_uset_bitmap_words(bucket_count) : 0;
+        const size_t new_words = _ctl_uset_bitmap_words(new_size);
+        self->used = (uint64_t *)CTL_REALLOC(self->used, new_words * sizeof(uint64_t));
+        ASSERT(self->used && "out of memory");
+        if (new_words > words)
+            memset(&self->used[words], 0, (new_words - words) * sizeof(uint64_t));
+    }
+#endif
     self->bucket_max = new_size - 1;
     if (self->size > 127)
         self->max_bucket_count = JOIN(A, max_bucket_count(self));
@@ -599,7 +1313,7 @@ static inline void JOIN(A, _rehash)(A *self, size_t count);
 
 static inline void JOIN(A, reserve)(A *self, size_t desired_count)
 {
-    if ((int32_t)desired_count <= 0)
+    if (desired_count == 0 || desired_count > JOIN(A, max_size)())
         return;
 #ifdef CTL_USET_GROWTH_POWER2
     const size_t new_size = JOIN(A, __next_power2)(desired_count);
@@ -625,12 +1339,24 @@ static inline A JOIN(A, init)(size_t (*_hash)(T *), int (*_equal)(T *, T *))
 #else
     self.free = JOIN(T, free);
     self.copy = JOIN(T, copy);
+#endif
+#ifdef CTL_USET_SEEDED
+    self.seed = CTL_USET_SEED;
 #endif
     JOIN(A, max_load_factor)(&self, 1.0f); // better would be 0.95
     JOIN(A, _reserve)(&self, 8);
     return self;
 }
 
+#ifdef CTL_USET_SEEDED
+// Only before the first insert, the hashes of the present nodes would change.
+static inline void JOIN(A, seed)(A *self, size_t seed)
+{
+    ASSERT(!self->size || !"seed only an empty container");
+    self->seed = seed;
+}
+#endif
+
 static inline A JOIN(A, init_from)(A *copy)
 {
     static A zero;
@@ -643,34 +1369,68 @@ static inline A JOIN(A, init_from)(A *copy)
 #endif
     self.hash = copy->hash;
     self.equal = copy->equal;
+#ifdef CTL_USET_SEEDED
+    self.seed = copy->seed;
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    self.compare = copy->compare;
+#endif
     return self;
 }
 
 static inline void JOIN(A, rehash)(A *self, size_t desired_count)
 {
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    JOIN(A, _rehash_finish)(self);
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(A, _coll_free)(self);
+#endif
     if (desired_count == (self->bucket_max + 1))
         return;
     A rehashed = JOIN(A, init)(self->hash, self->equal);
+#ifdef CTL_USET_SEEDED
+    rehashed.seed = self->seed; // before the nodes are moved
+#endif
     JOIN(A, reserve)(&rehashed, desired_count);
     if (LIKELY(self->buckets && self->size)) // if desired_count 0
     {
+#ifdef CTL_USET_BUCKET_BITMAP
+        for (size_t i = JOIN(A, _next_used)(self, 0); i <= self->bucket_max;
+             i = JOIN(A, _next_used)(self, i + 1))
+        {
+            B* node = self->buckets[i];
+#else
         B **b_last = &self->buckets[self->bucket_max];
         for (B **b = self->buckets; b <= b_last; b++)
         {
             B* node = *b;
+#endif
             while (node)
             {
                 B* next = node->next;
                 B **buckets = JOIN(A, _cached_bucket)(&rehashed, node);
-                JOIN(B, push)(buckets, node);
+                JOIN(A, _push)(&rehashed, buckets, node);
                 node = next;
             }
         }
     }
     rehashed.size = self->size;
+#ifdef CTL_USET_NODE_POOL
+    rehashed.pool = self->pool;
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    rehashed.compare = self->compare;
+#endif
     // LOG ("rehash temp. from %lu to %lu, load %f\n", rehashed.size, rehashed.bucket_count,
     //     JOIN(A, load_factor)(self));
-    free(self->buckets);
+    CTL_FREE(self->buckets);
+#ifdef CTL_USET_BUCKET_BITMAP
+    CTL_FREE(self->used);
+#endif
     // LOG ("free old\n");
     *self = rehashed;
 }
@@ -678,32 +1438,59 @@ static inline void JOIN(A, rehash)(A *self, size_t desired_count)
 // count: guaranteed growth policy (power2 or prime)
 static inline void JOIN(A, _rehash)(A *self, size_t count)
 {
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    JOIN(A, _rehash_finish)(self);
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(A, _coll_free)(self);
+#endif
     // we do allow shrink here
     if (count == self->bucket_max + 1)
         return;
     A rehashed = JOIN(A, init)(self->hash, self->equal);
+#ifdef CTL_USET_SEEDED
+    rehashed.seed = self->seed; // before the nodes are moved
+#endif
     //LOG("_rehash %zu => %zu\n", self->size, count);
     JOIN(A, _reserve)(&rehashed, count);
 
     if (LIKELY(self->buckets && self->size)) // if desired_count 0
     {
+#ifdef CTL_USET_BUCKET_BITMAP
+        for (size_t i = JOIN(A, _next_used)(self, 0); i <= self->bucket_max;
+             i = JOIN(A, _next_used)(self, i + 1))
+        {
+            B* node = self->buckets[i];
+#else
         B **b_last = &self->buckets[self->bucket_max];
         for (B **b = self->buckets; b <= b_last; b++)
         {
             B* node = *b;
+#endif
             while (node)
             {
                 B* next = node->next;
                 B **buckets = JOIN(A, _cached_bucket)(&rehashed, node);
-                JOIN(B, push)(buckets, node);
+                JOIN(A, _push)(&rehashed, buckets, node);
                 node = next;
             }
         }
     }
     rehashed.size = self->size;
+#ifdef CTL_USET_NODE_POOL
+    rehashed.pool = self->pool;
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    rehashed.compare = self->compare;
+#endif
     //LOG ("_rehash from %lu to %lu, load %f\n", rehashed.size, count,
     //     JOIN(A, load_factor)(self));
-    free(self->buckets);
+    CTL_FREE(self->buckets);
+#ifdef CTL_USET_BUCKET_BITMAP
+    CTL_FREE(self->used);
+#endif
     *self = rehashed;
 }
 
@@ -714,7 +1501,7 @@ static inline B *JOIN(A, find_node)(A *self, T value)
     if (self->size)
     {
 #ifdef CTL_USET_CACHED_HASH
-        size_t hash = self->hash(&value);
+        size_t hash = JOIN(A, _hash)(self, &value);
         B **buckets = JOIN(A, _bucket_hash)(self, hash);
 #else
         B **buckets = JOIN(A, _bucket)(self, value);
@@ -722,14 +1509,12 @@ static inline B *JOIN(A, find_node)(A *self, T value)
 #if CTL_USET_SECURITY_COLLCOUNTING > 1
         unsigned int count = 0;
 #endif
-#if CTL_USET_SECURITY_COLLCOUNTING == 1
-        return JOIN(B, find_sorted_vector)(buckets, value);
-#elif CTL_USET_SECURITY_COLLCOUNTING == 4
-        if (self->is_sorted_vector)
-            return JOIN(B, find_sorted_vector)(buckets, value);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+        if (JOIN(A, _sorted)(self, buckets))
+            return JOIN(B, find_sorted_vector)(self, buckets, &value);
 #elif CTL_USET_SECURITY_COLLCOUNTING == 5
-        if (self->is_map)
-            return JOIN(B, find_map)(self, value);
+        if (JOIN(A, _tree)(self, buckets))
+            return JOIN(B, find_map)(self, buckets, &value);
 #endif
 
         for (B *n = *buckets; n; n = n->next)
@@ -757,7 +1542,7 @@ static inline B *JOIN(A, find_node)(A *self, T value)
 #endif
                 return n;
             }
-#if CTL_USET_SECURITY_COLLCOUNTING
+#if CTL_USET_SECURITY_COLLCOUNTING > 1
             // with max 2^32 keys, 128 collisions is safely considered a DDOS attack.
             if (++count & 128)
             {
@@ -766,15 +1551,36 @@ static inline B *JOIN(A, find_node)(A *self, T value)
 # elif CTL_USET_SECURITY_COLLCOUNTING == 3
                 CTL_USET_SECURITY_ACTION;
 # elif CTL_USET_SECURITY_COLLCOUNTING == 4
-                JOIN(B, change_to_sorted_vector)(self, buckets);
-                return JOIN(B, find_sorted_vector)(buckets, value);
+                if (JOIN(B, change_to_sorted_vector)(self, buckets))
+                    return JOIN(B, find_sorted_vector)(self, buckets, &value);
 # elif CTL_USET_SECURITY_COLLCOUNTING == 5
-                JOIN(B, change_to_map)(self);
-                return JOIN(B, find_map)(self, value);
+                if (JOIN(B, change_to_map)(self, buckets))
+                    return JOIN(B, find_map)(self, buckets, &value);
 # endif
             }
 #endif
         }
+#ifdef CTL_USET_INCREMENTAL_REHASH
+        // not yet migrated
+        if (self->old_buckets)
+        {
+#ifdef CTL_USET_CACHED_HASH
+            buckets = JOIN(A, _old_bucket_hash)(self, hash);
+#else
+            buckets = JOIN(A, _old_bucket_hash)(self, JOIN(A, _hash)(self, &value));
+#endif
+            if (buckets)
+                for (B *n = *buckets; n; n = n->next)
+                {
+#ifdef CTL_USET_CACHED_HASH
+                    if (n->cached_hash != hash)
+                        continue;
+#endif
+                    if (self->equal(&value, &n->value))
+                        return n;
+                }
+        }
+#endif
     }
     return NULL;
 }
@@ -790,24 +1596,18 @@ static inline I JOIN(A, find)(A *self, T value)
 
 static inline B **JOIN(A, push_cached)(A *self, T *value)
 {
-#if CTL_USET_SECURITY_COLLCOUNTING == 1
-    B **buckets = JOIN(A, _bucket)(self, *value);
-    return JOIN(B, insert_sorted_vector)(buckets, value);
-#elif CTL_USET_SECURITY_COLLCOUNTING == 4
-    if (self->is_sorted_vector)
-        return JOIN(B, insert_sorted_vector)(JOIN(A, _bucket)(self, *value), value);
-#elif CTL_USET_SECURITY_COLLCOUNTING == 5
-    if (self->is_map)
-        return JOIN(B, insert_map)(self, value);
-#endif
-
 #ifdef CTL_USET_CACHED_HASH
-    size_t hash = self->hash(value);
+    size_t hash = JOIN(A, _hash)(self, value);
     B **buckets = JOIN(A, _bucket_hash)(self, hash);
-    JOIN(B, push)(buckets, JOIN(B, init_cached)(*value, hash));
+    JOIN(A, _push)(self, buckets, JOIN(A, _node_init_cached)(self, *value, hash));
 #else
     B **buckets = JOIN(A, _bucket)(self, *value);
-    JOIN(B, push)(buckets, JOIN(B, init)(*value));
+    JOIN(A, _push)(self, buckets, JOIN(A, _node_init)(self, *value));
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+    JOIN(B, insert_sorted_vector)(self, buckets, *buckets);
+#elif CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(B, insert_map)(self, buckets, *buckets);
 #endif
     // LOG ("push_bucket[%zu]\n", JOIN(B, bucket_size)(*buckets));
     self->size++;
@@ -817,11 +1617,19 @@ static inline B **JOIN(A, push_cached)(A *self, T *value)
 // the various growth polices before insert
 static inline void JOIN(A, _pre_insert_grow)(A *self)
 {
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (self->old_buckets)
+        JOIN(A, _rehash_step)(self, CTL_USET_REHASH_STEP);
+#endif
     if (!self->bucket_max)
         JOIN(A, rehash)(self, 8);
     if (self->size + 1 > self->max_bucket_count)
     {
-#ifdef CTL_USET_GROWTH_POWER2
+#if defined CTL_USET_INCREMENTAL_REHASH && defined CTL_USET_GROWTH_POWER2
+        JOIN(A, _rehash_start)(self, CTL_USET_GROWTH_FACTOR * (self->bucket_max + 1));
+#elif defined CTL_USET_INCREMENTAL_REHASH
+        JOIN(A, _rehash_start)(self, JOIN(A, __next_prime)(CTL_USET_GROWTH_FACTOR * (double)(self->bucket_max + 1)));
+#elif defined CTL_USET_GROWTH_POWER2
         const size_t bucket_count = CTL_USET_GROWTH_FACTOR * (self->bucket_max + 1);
         // LOG ("rehash from %lu to %lu, load %f\n", self->size, self->bucket_count,
         //     JOIN(A, load_factor)(self));
@@ -898,8 +1706,12 @@ static inline I JOIN(A, emplace_hint)(I *pos, T *value)
     A *self = pos->container;
     if (!JOIN(I, done)(pos))
     {
+#ifdef CTL_USET_INCREMENTAL_REHASH
+        // the hint path only searches the new bucket
+        JOIN(A, _rehash_finish)(self);
+#endif
 #ifdef CTL_USET_CACHED_HASH
-        size_t hash = self->hash(value);
+        size_t hash = JOIN(A, _hash)(self, value);
         B **buckets = JOIN(A, _bucket_hash)(self, hash);
 #else
         B **buckets = JOIN(A, _bucket)(self, *value);
@@ -907,15 +1719,28 @@ static inline I JOIN(A, emplace_hint)(I *pos, T *value)
 #if CTL_USET_SECURITY_COLLCOUNTING > 1
         unsigned int count = 0;
 #endif
-#if CTL_USET_SECURITY_COLLCOUNTING == 1
-        if (!JOIN(B, find_sorted_vector)(buckets, value))
-            return JOIN(B, insert_sorted_vector)(buckets, value);
-#elif CTL_USET_SECURITY_COLLCOUNTING == 4
-        if (self->is_sorted_vector && !JOIN(B, find_sorted_vector)(buckets, value))
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+        if (JOIN(A, _sorted)(self, buckets))
+        {
+            B *n = JOIN(B, find_sorted_vector)(self, buckets, value);
+            if (n)
+            {
+                FREE_VALUE(self, *value);
+                return JOIN(I, iter)(self, n);
+            }
             goto not_found;
+        }
 #elif CTL_USET_SECURITY_COLLCOUNTING == 5
-        if (self->is_map && !JOIN(B, find_map)(self, value))
+        if (JOIN(A, _tree)(self, buckets))
+        {
+            B *n = JOIN(B, find_map)(self, buckets, value);
+            if (n)
+            {
+                FREE_VALUE(self, *value);
+                return JOIN(I, iter)(self, n);
+            }
             goto not_found;
+        }
 #endif
 
         for (B *n = *buckets; n; n = n->next)
@@ -929,7 +1754,7 @@ static inline I JOIN(A, emplace_hint)(I *pos, T *value)
                 FREE_VALUE(self, *value);
                 return JOIN(I, iter)(self, n);
             }
-#if CTL_USET_SECURITY_COLLCOUNTING
+#if CTL_USET_SECURITY_COLLCOUNTING > 1
             // with max 2^32 keys, 128 collisions is safely considered a DDOS attack.
             if (++count & 128)
             {
@@ -938,42 +1763,51 @@ static inline I JOIN(A, emplace_hint)(I *pos, T *value)
 # elif CTL_USET_SECURITY_COLLCOUNTING == 3
                 CTL_USET_SECURITY_ACTION;
 # elif CTL_USET_SECURITY_COLLCOUNTING == 4
-                JOIN(B, change_to_sorted_vector)(self, buckets);
-                n = JOIN(B, find_sorted_vector)(buckets, value);
-                if (n)
-                    return JOIN(I, iter)(self, n);
-                else
+                if (JOIN(B, change_to_sorted_vector)(self, buckets))
+                {
+                    n = JOIN(B, find_sorted_vector)(self, buckets, value);
+                    if (n)
+                    {
+                        FREE_VALUE(self, *value);
+                        return JOIN(I, iter)(self, n);
+                    }
                     break;
+                }
 # elif CTL_USET_SECURITY_COLLCOUNTING == 5
-                JOIN(B, change_to_map)(self);
-                n = JOIN(B, find_map)(self, value);
-                if (n)
-                    return JOIN(I, iter)(self, n);
-                else
+                if (JOIN(B, change_to_map)(self, buckets))
+                {
+                    n = JOIN(B, find_map)(self, buckets, value);
+                    if (n)
+                    {
+                        FREE_VALUE(self, *value);
+                        return JOIN(I, iter)(self, n);
+                    }
                     break;
+                }
 # endif
             }
 #endif
         }
-#if CTL_USET_SECURITY_COLLCOUNTING == 4 || CTL_USET_SECURITY_COLLCOUNTING == 5
-    not_found:
-#endif
-        B *node = (B *)calloc(1, sizeof(B));
-        memcpy(&node->value, value, sizeof(T));
-#if CTL_USET_SECURITY_COLLCOUNTING == 4
-        if (self->is_sorted_vector)
-            return JOIN(B, insert_sorted_vector)(buckets, *value);
-#elif CTL_USET_SECURITY_COLLCOUNTING == 5
-        if (self->is_map)
-            return JOIN(B, insert_map)(self, *value);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    not_found:;
+#endif
+#ifdef CTL_USET_CACHED_HASH
+        B *node = JOIN(A, _node_init_cached)(self, *value, hash);
 #else
-        JOIN(B, push)(buckets, node);
+        B *node = JOIN(A, _node_init)(self, *value);
+#endif
+        JOIN(A, _push)(self, buckets, node);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+        JOIN(B, insert_sorted_vector)(self, buckets, node);
+#elif CTL_USET_SECURITY_COLLCOUNTING == 5
+        JOIN(B, insert_map)(self, buckets, node);
+#endif
         pos->container->size++;
         pos->node = node;
         JOIN(I, update)(pos);
         pos->buckets = buckets;
         return *pos;
-#endif
     }
     else
     {
@@ -985,9 +1819,41 @@ static inline I JOIN(A, emplace_hint)(I *pos, T *value)
 
 static inline void JOIN(A, clear)(A *self)
 {
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    JOIN(A, _rehash_finish)(self);
+#endif
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(A, _coll_free)(self);
+#endif
+#ifdef CTL_USET_NODE_POOL
+    if (LIKELY(self->buckets))
+    {
+        // only the values need to be freed, the nodes go with their chunks
+        if (self->free && self->size)
+#ifdef CTL_USET_BUCKET_BITMAP
+            for (size_t i = JOIN(A, _next_used)(self, 0); i <= self->bucket_max;
+                 i = JOIN(A, _next_used)(self, i + 1))
+#else
+            for (size_t i = 0; i <= self->bucket_max; i++)
+#endif
+                for (B *n = self->buckets[i]; n; n = n->next)
+                    self->free(&n->value);
+        memset(self->buckets, 0, (self->bucket_max + 1) * sizeof(B *));
+#ifdef CTL_USET_BUCKET_BITMAP
+        memset(self->used, 0, _ctl_uset_bitmap_words(self->bucket_max + 1) * sizeof(uint64_t));
+#endif
+    }
+    JOIN(A, _pool_free)(self);
+#else
     if (LIKELY(self->buckets))
     {
+#ifdef CTL_USET_BUCKET_BITMAP
+        for (size_t i = JOIN(A, _next_used)(self, 0); i <= self->bucket_max;
+             i = JOIN(A, _next_used)(self, i + 1))
+#else
         for (size_t i = 0; i <= self->bucket_max; i++)
+#endif
         {
             B *next;
             B *n = self->buckets[i];
@@ -1001,9 +1867,13 @@ static inline void JOIN(A, clear)(A *self)
             JOIN(A, _free_node)(self, n);
         }
         memset(self->buckets, 0, (self->bucket_max + 1) * sizeof(B *));
+#ifdef CTL_USET_BUCKET_BITMAP
+        memset(self->used, 0, _ctl_uset_bitmap_words(self->bucket_max + 1) * sizeof(uint64_t));
+#endif
         /* for(size_t i = 0; i <= self->bucket_max; i++)
            self->buckets[i] = NULL; */
     }
+#endif
     self->size = 0;
     // self->max_bucket_count = 0;
 }
@@ -1012,8 +1882,12 @@ static inline void JOIN(A, free)(A *self)
 {
     // LOG("free calloc %zu, %zu\n", self->bucket_max, self->size);
     JOIN(A, clear)(self);
-    free(self->buckets);
+    CTL_FREE(self->buckets);
     self->buckets = NULL;
+#ifdef CTL_USET_BUCKET_BITMAP
+    CTL_FREE(self->used);
+    self->used = NULL;
+#endif
     self->bucket_max = 0;
 }
 
@@ -1048,25 +1922,140 @@ static inline bool JOIN(A, contains)(A *self, T value)
     }
 }
 
+// Batched lookup: first hash all keys of a chunk and prefetch their buckets,
+// then prefetch the chain heads, and only then walk the chains. The cache
+// misses of the chunk overlap, instead of being serialized key by key.
+// Long or indexed chains, and a pending incremental rehash, fall back to
+// find_node.
+static inline void JOIN(A, _find_chunk)(A *self, T *keys, size_t n, B **nodes)
+{
+    B **buckets[CTL_USET_BATCH];
+    size_t hashes[CTL_USET_BATCH];
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    if (self->old_buckets)
+    {
+        for (size_t i = 0; i < n; i++)
+            nodes[i] = JOIN(A, find_node)(self, keys[i]);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++)
+    {
+        hashes[i] = JOIN(A, _hash)(self, &keys[i]);
+        buckets[i] = JOIN(A, _bucket_hash)(self, hashes[i]);
+        PREFETCH(buckets[i]);
+    }
+    for (size_t i = 0; i < n; i++)
+        PREFETCH(*buckets[i]);
+    for (size_t i = 0; i < n; i++)
+    {
+        unsigned int count = 0;
+        B *node;
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+        if (JOIN(A, _sorted)(self, buckets[i]))
+        {
+            nodes[i] = JOIN(B, find_sorted_vector)(self, buckets[i], &keys[i]);
+            continue;
+        }
+#elif CTL_USET_SECURITY_COLLCOUNTING == 5
+        if (JOIN(A, _tree)(self, buckets[i]))
+        {
+            nodes[i] = JOIN(B, find_map)(self, buckets[i], &keys[i]);
+            continue;
+        }
+#endif
+        for (node = *buckets[i]; node; node = node->next)
+        {
+#ifdef CTL_USET_CACHED_HASH
+            if (node->cached_hash == hashes[i] && self->equal(&keys[i], &node->value))
+#else
+            if (self->equal(&keys[i], &node->value))
+#endif
+                break;
+            // leave the collision policy to find_node
+            if (UNLIKELY(++count & 128))
+            {
+                node = JOIN(A, find_node)(self, keys[i]);
+                break;
+            }
+        }
+        nodes[i] = node;
+    }
+}
+
+// Stores a pointer to the found value, or NULL, for each of the n keys.
+// The keys are not consumed, as with find.
+static inline void JOIN(A, find_batch)(A *self, T *keys, size_t n, T **results)
+{
+    B *nodes[CTL_USET_BATCH];
+    for (size_t i = 0; i < n; i += CTL_USET_BATCH)
+    {
+        size_t chunk = n - i < CTL_USET_BATCH ? n - i : CTL_USET_BATCH;
+        if (!self->size)
+            memset(nodes, 0, sizeof(nodes));
+        else
+            JOIN(A, _find_chunk)(self, &keys[i], chunk, nodes);
+        for (size_t j = 0; j < chunk; j++)
+            results[i + j] = nodes[j] ? &nodes[j]->value : NULL;
+    }
+}
+
+// The keys are consumed, as with contains.
+static inline void JOIN(A, contains_batch)(A *self, T *keys, size_t n, bool *results)
+{
+    B *nodes[CTL_USET_BATCH];
+    for (size_t i = 0; i < n; i += CTL_USET_BATCH)
+    {
+        size_t chunk = n - i < CTL_USET_BATCH ? n - i : CTL_USET_BATCH;
+        if (!self->size)
+            memset(nodes, 0, sizeof(nodes));
+        else
+            JOIN(A, _find_chunk)(self, &keys[i], chunk, nodes);
+        for (size_t j = 0; j < chunk; j++)
+        {
+            results[i + j] = nodes[j] != NULL;
+            FREE_VALUE(self, keys[i + j]);
+        }
+    }
+}
+
 static inline void JOIN(A, _linked_erase)(A *self, B **bucket, B *n, B *prev, B *next)
 {
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4
+    JOIN(B, erase_sorted_vector)(self, bucket, n);
+#elif CTL_USET_SECURITY_COLLCOUNTING == 5
+    JOIN(B, erase_map)(self, bucket, n);
+#endif
     JOIN(A, _free_node)(self, n);
     if (prev)
         prev->next = next;
     else
+    {
         *bucket = next;
+#ifdef CTL_USET_BUCKET_BITMAP
+        if (!next
+#ifdef CTL_USET_INCREMENTAL_REHASH
+            && !JOIN(A, _is_old_bucket)(self, bucket)
+#endif
+        )
+            JOIN(A, _unmark)(self, bucket);
+#endif
+    }
 }
 
 static inline void JOIN(A, erase)(A *self, T value)
 {
 #ifdef CTL_USET_CACHED_HASH
-    size_t hash = self->hash(&value);
+    size_t hash = JOIN(A, _hash)(self, &value);
     B **buckets = JOIN(A, _bucket_hash)(self, hash);
 #else
     B **buckets = JOIN(A, _bucket)(self, value);
 #endif
     B *prev = NULL;
     B *n = *buckets;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+again:
+#endif
     while (n)
     {
         B *next = n->next;
@@ -1081,17 +2070,42 @@ static inline void JOIN(A, erase)(A *self, T value)
         if (self->equal(&value, &n->value))
         {
             JOIN(A, _linked_erase)(self, buckets, n, prev, next);
-            break;
+            return;
         }
         prev = n;
         n = next;
     }
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    // not yet migrated
+    if (self->old_buckets && !JOIN(A, _is_old_bucket)(self, buckets))
+    {
+#ifdef CTL_USET_CACHED_HASH
+        buckets = JOIN(A, _old_bucket_hash)(self, hash);
+#else
+        buckets = JOIN(A, _old_bucket_hash)(self, JOIN(A, _hash)(self, &value));
+#endif
+        if (buckets)
+        {
+            prev = NULL;
+            n = *buckets;
+            goto again;
+        }
+    }
+#endif
 }
 
 static inline size_t JOIN(A, erase_if)(A *self, int (*_match)(T *))
 {
     size_t erases = 0;
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    JOIN(A, _rehash_finish)(self);
+#endif
+#ifdef CTL_USET_BUCKET_BITMAP
+    for (size_t i = JOIN(A, _next_used)(self, 0); i <= self->bucket_max;
+         i = JOIN(A, _next_used)(self, i + 1))
+#else
     for (size_t i = 0; i <= self->bucket_max; i++)
+#endif
     {
         B **buckets = &self->buckets[i];
         B *prev = NULL;
@@ -1116,6 +2130,10 @@ static inline A JOIN(A, copy)(A *self)
 {
     // LOG ("copy\norig size: %lu\n", self->size);
     A other = JOIN(A, init)(self->hash, self->equal);
+#if CTL_USET_SECURITY_COLLCOUNTING == 1 || CTL_USET_SECURITY_COLLCOUNTING == 4 || \
+    CTL_USET_SECURITY_COLLCOUNTING == 5
+    other.compare = self->compare;
+#endif
     JOIN(A, _reserve)(&other, self->bucket_max + 1);
     foreach (A, self, it)
     {
@@ -1322,6 +2340,13 @@ static inline A JOIN(A, transform)(A *self, T _unop(T *))
 #endif
 
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #ifndef HOLD
 #undef A
 #undef B
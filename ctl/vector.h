@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <ctl/ctl.h>
+#include <ctl/bits/alloc.h>
 
 // only for short strings, not vec_uint8_t
 #ifndef MUST_ALIGN_16
@@ -23,6 +24,28 @@
 #define INIT_SIZE 15
 #endif
 
+// the capacity growth of push_back and insert, e.g. 1.5. strings double.
+#ifndef CTL_VEC_GROWTH_FACTOR
+#define CTL_VEC_GROWTH_FACTOR 2
+#endif
+
+// POD vectors with at least CTL_VEC_MMAP bytes are mmap'ed with transparent
+// huge pages, and grow by mremap without a copy, with _GNU_SOURCE on linux.
+// Not with CTL_ALLOC.
+#if defined CTL_VEC_MMAP && defined POD && !defined CTL_STR && !defined CTL_SVEC && defined _CTL_ALLOC_DEFAULT &&     \
+    !defined _WIN32
+#define _CTL_VEC_MMAP
+#include <sys/mman.h>
+#endif
+
+// the elements kept inline in the struct: N of a small_vector, the short
+// strings without their \0
+#ifdef CTL_SVEC
+#define _CTL_VEC_SMALL N
+#elif defined CTL_STR
+#define _CTL_VEC_SMALL CTL_STR_SSO
+#endif
+
 typedef struct A
 {
     T *vector;
@@ -32,8 +55,17 @@ typedef struct A
     int (*equal)(T *, T *);   // optional
     size_t size;
     size_t capacity;
+#ifdef _CTL_VEC_SMALL
+    T small[_CTL_VEC_SMALL + MUST_ALIGN_16(T)]; // up to _CTL_VEC_SMALL elements, then vector
+#endif
 } A;
 
+#ifdef _CTL_VEC_SMALL
+#define _CTL_VEC_DATA(self) ((self)->capacity > _CTL_VEC_SMALL ? (self)->vector : (self)->small)
+#else
+#define _CTL_VEC_DATA(self) ((self)->vector)
+#endif
+
 typedef int (*JOIN(A, compare_fn))(T *, T *);
 
 #include <ctl/bits/iterator_vtable.h>
@@ -53,12 +85,12 @@ static inline size_t JOIN(A, capacity)(A *self)
 static inline T *JOIN(A, at)(A *self, size_t index)
 {
     ASSERT(index < self->size || !"out of range");
-    return index < self->size ? &self->vector[index] : NULL;
+    return index < self->size ? &_CTL_VEC_DATA(self)[index] : NULL;
 }
 
 static inline T *JOIN(A, front)(A *self)
 {
-    return &self->vector[0]; // not bounds-checked
+    return &_CTL_VEC_DATA(self)[0]; // not bounds-checked
 }
 
 static inline T *JOIN(A, back)(A *self)
@@ -173,8 +205,8 @@ static inline I JOIN(I, iter)(A *self, size_t index)
 {
     static I zero;
     I iter = zero;
-    iter.ref = &self->vector[index];
-    iter.end = &self->vector[self->size];
+    iter.ref = &_CTL_VEC_DATA(self)[index];
+    iter.end = &_CTL_VEC_DATA(self)[self->size];
     iter.container = self;
     //iter.vtable = { JOIN(I, next), JOIN(I, ref), JOIN(I, done) };
     iter.vtable.next = JOIN(I, next);
@@ -187,6 +219,9 @@ static inline A JOIN(A, init)(void)
 {
     static A zero;
     A self = zero;
+#ifdef _CTL_VEC_SMALL
+    self.capacity = _CTL_VEC_SMALL;
+#endif
 #ifdef POD
     self.copy = JOIN(A, implicit_copy);
     _JOIN(A, _set_default_methods)(&self);
@@ -201,6 +236,9 @@ static inline A JOIN(A, init_from)(A *copy)
 {
     static A zero;
     A self = zero;
+#ifdef _CTL_VEC_SMALL
+    self.capacity = _CTL_VEC_SMALL;
+#endif
     self.free = copy->free;
     self.copy = copy->copy;
     self.compare = copy->compare;
@@ -211,7 +249,7 @@ static inline A JOIN(A, init_from)(A *copy)
 // not bounds-checked. like operator[]
 static inline void JOIN(A, set)(A *self, size_t index, T value)
 {
-    T *ref = &self->vector[index];
+    T *ref = &_CTL_VEC_DATA(self)[index];
     if (self->free)
         self->free(ref);
     *ref = value;
@@ -219,20 +257,113 @@ static inline void JOIN(A, set)(A *self, size_t index, T value)
 
 static inline void JOIN(A, pop_back)(A *self)
 {
-    static T zero;
     self->size--;
-    JOIN(A, set)(self, self->size, zero);
+#ifndef POD
+    if (self->free)
+        self->free(&_CTL_VEC_DATA(self)[self->size]);
+#endif
+#ifdef CTL_STR
+    _CTL_VEC_DATA(self)[self->size] = '\0';
+#endif
 }
 
+#ifdef _CTL_VEC_MMAP
+static inline bool JOIN(A, _mapped)(size_t capacity)
+{
+    return capacity * sizeof(T) >= (size_t)(CTL_VEC_MMAP);
+}
+
+// Moves to, within or off mmap'ed memory. The mapped state follows from the
+// capacity.
+static inline void JOIN(A, _remap)(A *self, size_t capacity)
+{
+    const size_t old_bytes = self->capacity * sizeof(T);
+    const size_t bytes = capacity * sizeof(T);
+    const size_t used = (self->size < capacity ? self->size : capacity) * sizeof(T);
+    T *vector;
+    if (!JOIN(A, _mapped)(capacity))
+    {
+        vector = (T *)_CTL_CALLOC(capacity ? capacity : 1, sizeof(T));
+        ASSERT(vector || !"out of memory");
+        memcpy(vector, self->vector, used);
+        munmap(self->vector, old_bytes);
+    }
+#ifdef MREMAP_MAYMOVE
+    else if (self->vector && JOIN(A, _mapped)(self->capacity))
+    {
+        vector = (T *)mremap(self->vector, old_bytes, bytes, MREMAP_MAYMOVE);
+        ASSERT(vector != MAP_FAILED || !"out of memory");
+    }
+#endif
+    else
+    {
+        vector = (T *)mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        ASSERT(vector != MAP_FAILED || !"out of memory");
+        if (self->vector)
+        {
+            memcpy(vector, self->vector, used);
+            if (JOIN(A, _mapped)(self->capacity))
+                munmap(self->vector, old_bytes);
+            else
+                CTL_FREE(self->vector);
+        }
+    }
+#ifdef MADV_HUGEPAGE
+    if (JOIN(A, _mapped)(capacity))
+        madvise(vector, bytes, MADV_HUGEPAGE);
+#endif
+    self->vector = vector;
+    self->capacity = capacity;
+}
+#endif
+
+#ifdef _CTL_VEC_SMALL
+// Moves the elements from the inline storage to the heap, or back. Strings
+// with their \0.
+static inline void JOIN(A, _spill)(A *self, size_t capacity)
+{
+    if (capacity <= _CTL_VEC_SMALL)
+    {
+        if (self->capacity > _CTL_VEC_SMALL)
+        {
+            ASSERT(self->size <= _CTL_VEC_SMALL);
+            memcpy(self->small, self->vector, (self->size + MUST_ALIGN_16(T)) * sizeof(T));
+            CTL_FREE(self->vector);
+            self->vector = NULL;
+            self->capacity = _CTL_VEC_SMALL;
+        }
+        return;
+    }
+    self->vector = (T *)_CTL_CALLOC(capacity + MUST_ALIGN_16(T), sizeof(T));
+    ASSERT(self->vector || !"out of memory");
+    memcpy(self->vector, self->small, self->size * sizeof(T));
+    self->capacity = capacity;
+}
+#endif
+
 static inline void JOIN(A, fit)(A *self, size_t capacity)
 {
     size_t overall = capacity;
     ASSERT(capacity < JOIN(A, max_size)() || !"max_size overflow");
+#ifdef _CTL_VEC_MMAP
+    if (JOIN(A, _mapped)(capacity) || (self->vector && JOIN(A, _mapped)(self->capacity)))
+    {
+        JOIN(A, _remap)(self, capacity);
+        return;
+    }
+#endif
+#ifdef _CTL_VEC_SMALL
+    if (capacity <= _CTL_VEC_SMALL || self->capacity <= _CTL_VEC_SMALL)
+    {
+        JOIN(A, _spill)(self, capacity);
+        return;
+    }
+#endif
     if (MUST_ALIGN_16(T)) // reserve terminating \0 for strings
         overall++;
     if (self->vector)
     {
-        self->vector = (T *)realloc(self->vector, overall * sizeof(T));
+        self->vector = (T *)CTL_REALLOC(self->vector, overall * sizeof(T));
         if (MUST_ALIGN_16(T))
         {
 #if 0
@@ -246,17 +377,23 @@ static inline void JOIN(A, fit)(A *self, size_t capacity)
         }
     }
     else
-        self->vector = (T *)calloc(overall, sizeof(T));
+        self->vector = (T *)_CTL_CALLOC(overall, sizeof(T));
     self->capacity = capacity;
 }
 
+// drops the last n elements, POD ones in O(1)
 static inline void JOIN(A, wipe)(A *self, size_t n)
 {
-    while (n != 0)
-    {
-        JOIN(A, pop_back)(self);
-        n--;
-    }
+#ifndef POD
+    if (self->free)
+        for (size_t i = self->size; i > self->size - n; i--)
+            self->free(&_CTL_VEC_DATA(self)[i - 1]);
+#endif
+    self->size -= n;
+#ifdef CTL_STR
+    if (_CTL_VEC_DATA(self))
+        _CTL_VEC_DATA(self)[self->size] = '\0';
+#endif
 #if defined CTL_STR && defined _LIBCPP_STD_VER
     if (self->capacity <= 30)
         JOIN(A, fit)(self, 47);
@@ -274,7 +411,12 @@ static inline void JOIN(A, free)(A *self)
     JOIN(A, clear)(self);
     JOIN(A, compare_fn) *compare = &self->compare;
     JOIN(A, compare_fn) *equal = &self->equal;
-    free(self->vector);
+#ifdef _CTL_VEC_MMAP
+    if (self->vector && JOIN(A, _mapped)(self->capacity))
+        munmap(self->vector, self->capacity * sizeof(T));
+    else
+#endif
+        CTL_FREE(self->vector);
     *self = JOIN(A, init)();
     self->compare = *compare;
     self->equal = *equal;
@@ -325,21 +467,50 @@ static inline void JOIN(A, reserve)(A *self, const size_t n)
     }
 }
 
+// Opens count uninitialized elements at index, with one move of the tail.
+// The capacity must be reserved already.
+static inline T *JOIN(A, _gap)(A *self, size_t index, size_t count)
+{
+    ASSERT(self->size + count <= self->capacity);
+    if (count == 0)
+        return &_CTL_VEC_DATA(self)[index];
+    if (index < self->size)
+        memmove(&_CTL_VEC_DATA(self)[index + count], &_CTL_VEC_DATA(self)[index], (self->size - index) * sizeof(T));
+    self->size += count;
+#ifdef CTL_STR
+    _CTL_VEC_DATA(self)[self->size] = '\0';
+#endif
+    return &_CTL_VEC_DATA(self)[index];
+}
+
+// the next capacity when full
+static inline size_t JOIN(A, _grown)(A *self)
+{
+    if (self->capacity == 0)
+        return INIT_SIZE;
+#ifdef CTL_STR
+    return 2 * self->capacity;
+#else
+    const size_t grown = (size_t)(self->capacity * CTL_VEC_GROWTH_FACTOR);
+    return grown > self->capacity ? grown : self->capacity + 1;
+#endif
+}
+
 static inline void JOIN(A, push_back)(A *self, T value)
 {
     if (self->size == self->capacity)
-        JOIN(A, reserve)(self, self->capacity == 0 ? INIT_SIZE : 2 * self->capacity);
+        JOIN(A, reserve)(self, JOIN(A, _grown)(self));
     self->size++;
     *JOIN(A, at)(self, self->size - 1) = value;
 #ifdef CTL_STR
-    self->vector[self->size] = '\0';
+    _CTL_VEC_DATA(self)[self->size] = '\0';
 #endif
 }
 
 static inline void JOIN(A, emplace_back)(A *self, T *value)
 {
     if (self->size == self->capacity)
-        JOIN(A, reserve)(self, self->capacity == 0 ? INIT_SIZE : 2 * self->capacity);
+        JOIN(A, reserve)(self, JOIN(A, _grown)(self));
     self->size++;
     *JOIN(A, at)(self, self->size - 1) = *value;
 }
@@ -349,11 +520,11 @@ static inline void JOIN(A, emplace)(I *pos, T *value)
     A *self = pos->container;
     if (!JOIN(I, done)(pos))
     {
-        size_t index = pos->ref - self->vector;
+        size_t index = pos->ref - _CTL_VEC_DATA(self);
         JOIN(A, emplace_back)(self, JOIN(A, back)(self));
         for (size_t i = self->size - 2; i > index; i--)
-            self->vector[i] = self->vector[i - 1];
-        self->vector[index] = *value;
+            _CTL_VEC_DATA(self)[i] = _CTL_VEC_DATA(self)[i - 1];
+        _CTL_VEC_DATA(self)[index] = *value;
     }
     else
         JOIN(A, emplace_back)(self, value);
@@ -379,13 +550,20 @@ static inline void JOIN(A, resize)(A *self, size_t size, T value)
 #else // different vector growth policy. double or just grow as needed.
             size_t capacity;
             size_t n = size > self->size ? size - self->size : 0;
-            capacity = self->size + (self->size > n ? self->size : n);
+            size_t more = (size_t)(self->size * (CTL_VEC_GROWTH_FACTOR - 1));
+            capacity = self->size + (more > n ? more : n);
             LOG("  grow vector by %zu with size %zu to %zu\n", n, self->size, capacity);
             JOIN(A, fit)(self, capacity);
 #endif
         }
-        for (size_t i = 0; self->size < size; i++)
-            JOIN(A, push_back)(self, self->copy(&value));
+        const size_t count = size - self->size;
+        T *ref = JOIN(A, _gap)(self, self->size, count);
+        for (size_t i = 0; i < count; i++)
+#ifdef POD
+            ref[i] = value;
+#else
+            ref[i] = self->copy(&value);
+#endif
     }
     if (self->free)
         self->free(&value);
@@ -393,11 +571,15 @@ static inline void JOIN(A, resize)(A *self, size_t size, T value)
 
 static inline void JOIN(A, assign)(A *self, size_t count, T value)
 {
-    JOIN(A, resize)(self, count, self->copy(&value));
-    for (size_t i = 0; i < count; i++)
+    // replace the kept elements, resize adds or drops the rest
+    const size_t kept = count < self->size ? count : self->size;
+    for (size_t i = 0; i < kept; i++)
+#ifdef POD
+        _CTL_VEC_DATA(self)[i] = value;
+#else
         JOIN(A, set)(self, i, self->copy(&value));
-    if (self->free)
-        self->free(&value);
+#endif
+    JOIN(A, resize)(self, count, value);
 }
 
 static inline void JOIN(A, assign_range)(A *self, T *from, T *last)
@@ -411,7 +593,7 @@ static inline void JOIN(A, assign_range)(A *self, T *from, T *last)
             JOIN(A, push_back)(self, self->copy(from));
         else
         {
-            T *ref = &self->vector[i];
+            T *ref = &_CTL_VEC_DATA(self)[i];
             if (self->free && i < orig_size)
                 self->free(ref);
             *ref = self->copy(from);
@@ -437,7 +619,7 @@ static inline void JOIN(A, assign_generic)(A *self, GI *range)
             JOIN(A, push_back)(self, self->copy(ref(range)));
         else
         {
-            T *sref = &self->vector[i];
+            T *sref = &_CTL_VEC_DATA(self)[i];
             if (self->free && i < orig_size)
                 self->free(sref); // replace
             *sref = self->copy(ref(range));
@@ -485,16 +667,9 @@ static inline T *JOIN(A, data)(A *self)
 
 static inline void JOIN(A, insert_index)(A *self, size_t index, T value)
 {
-    if (self->size > 0)
-    {
-        JOIN(A, push_back)(self, *JOIN(A, back)(self));
-        // TODO memmove with POD
-        for (size_t i = self->size - 2; i > index; i--)
-            self->vector[i] = self->vector[i - 1];
-        self->vector[index] = value;
-    }
-    else
-        JOIN(A, push_back)(self, value);
+    if (self->size == self->capacity)
+        JOIN(A, reserve)(self, JOIN(A, _grown)(self));
+    *JOIN(A, _gap)(self, index, 1) = value;
 }
 
 static inline I JOIN(A, erase_index)(A *self, size_t index)
@@ -502,16 +677,16 @@ static inline I JOIN(A, erase_index)(A *self, size_t index)
     static T zero;
 #if 1
     if (self->free)
-        self->free(&self->vector[index]);
+        self->free(&_CTL_VEC_DATA(self)[index]);
     if (index < self->size - 1)
-        memmove(&self->vector[index], &self->vector[index] + 1, (self->size - index - 1) * sizeof(T));
-    self->vector[self->size - 1] = zero;
+        memmove(&_CTL_VEC_DATA(self)[index], &_CTL_VEC_DATA(self)[index] + 1, (self->size - index - 1) * sizeof(T));
+    _CTL_VEC_DATA(self)[self->size - 1] = zero;
 #else
     JOIN(A, set)(self, index, zero);
     for (size_t i = index; i < self->size - 1; i++)
     {
-        self->vector[i] = self->vector[i + 1];
-        self->vector[i + 1] = zero;
+        _CTL_VEC_DATA(self)[i] = _CTL_VEC_DATA(self)[i + 1];
+        _CTL_VEC_DATA(self)[i + 1] = zero;
     }
 #endif
     self->size--;
@@ -523,7 +698,7 @@ static inline I *JOIN(A, erase_range)(I *range)
     if (JOIN(I, done)(range))
         return range;
     A *self = range->container;
-    T *end = &self->vector[self->size];
+    T *end = &_CTL_VEC_DATA(self)[self->size];
 #if 1
     size_t size = (range->end - range->ref);
 #ifndef POD
@@ -559,39 +734,33 @@ static inline void JOIN(A, insert)(I *pos, T value)
     if (!JOIN(I, done)(pos))
     {
         // before pos
-        size_t index = pos->ref - self->vector;
-        size_t end = pos->end - self->vector;
-        // TODO memmove with POD
-        JOIN(A, push_back)(self, *JOIN(A, back)(self));
-        for (size_t i = self->size - 2; i > index; i--)
-            self->vector[i] = self->vector[i - 1];
-        self->vector[index] = value;
-        pos->ref = &self->vector[index];
-        pos->end = &self->vector[end];
+        size_t index = pos->ref - _CTL_VEC_DATA(self);
+        size_t end = pos->end - _CTL_VEC_DATA(self);
+        JOIN(A, insert_index)(self, index, value);
+        pos->ref = &_CTL_VEC_DATA(self)[index];
+        pos->end = &_CTL_VEC_DATA(self)[end];
     }
     else
     {
         // or at end
         JOIN(A, push_back)(self, value);
-        pos->end = pos->ref = &self->vector[self->size];
+        pos->end = pos->ref = &_CTL_VEC_DATA(self)[self->size];
     }
 }
 
 static inline void JOIN(A, insert_count)(I *pos, size_t count, T value)
 {
     A *self = pos->container;
-    size_t index = pos->ref - self->vector;
+    // or at end
+    size_t index = JOIN(I, done)(pos) ? self->size : (size_t)(pos->ref - _CTL_VEC_DATA(self));
     JOIN(A, reserve)(self, self->size + count);
-    if (!JOIN(I, done)(pos))
-    {
-        for (size_t i = 0; i < count; i++)
-            JOIN(A, insert_index)(self, index++, self->copy(&value));
-    }
-    else
-    {
-        for (size_t i = 0; i < count; i++)
-            JOIN(A, push_back)(self, self->copy(&value));
-    }
+    T *ref = JOIN(A, _gap)(self, index, count);
+    for (size_t i = 0; i < count; i++)
+#ifdef POD
+        ref[i] = value;
+#else
+        ref[i] = self->copy(&value);
+#endif
 #if defined CTL_STR
     JOIN(A, reserve)(self, self->size);
 #endif
@@ -602,26 +771,35 @@ static inline void JOIN(A, insert_count)(I *pos, size_t count, T value)
 static inline void JOIN(A, insert_range)(I *pos, I *range2)
 {
     A *self = pos->container;
-    size_t index = pos->ref - self->vector;
-    size_t f2 = range2->ref - range2->container->vector;
-    size_t l2 = range2->end - range2->container->vector;
-    // only if not overlapping, and resize does no realloc
+    // or at end
+    size_t index = JOIN(I, done)(pos) ? self->size : (size_t)(pos->ref - _CTL_VEC_DATA(self));
+    size_t f2 = range2->ref - _CTL_VEC_DATA(range2->container);
+    size_t l2 = range2->end - _CTL_VEC_DATA(range2->container);
     if (f2 < l2)
     {
-        JOIN(A, reserve)(self, self->size + (l2 - f2));
+        const size_t count = l2 - f2;
+        JOIN(A, reserve)(self, self->size + count);
+        T *ref = JOIN(A, _gap)(self, index, count);
+        T *from = &_CTL_VEC_DATA(range2->container)[f2];
+        T *after = from;
+        size_t before = count;
         if (self == range2->container)
         {
-            range2->ref = &range2->container->vector[f2];
-            range2->end = &range2->container->vector[l2];
+            // from ourselves, the part after index moved behind the gap
+            before = f2 < index ? (l2 < index ? l2 : index) - f2 : 0;
+            after = &_CTL_VEC_DATA(self)[index + count + (f2 > index ? f2 - index : 0)];
+            range2->ref = &_CTL_VEC_DATA(self)[f2 + (f2 >= index ? count : 0)];
+            range2->end = &_CTL_VEC_DATA(self)[l2 + (l2 > index ? count : 0)];
         }
-    }
-    if (!JOIN(I, done)(pos))
-    {
-        foreach_range_(A, it, range2) if (it.ref) JOIN(A, insert_index)(self, index++, self->copy(it.ref));
-    }
-    else
-    {
-        foreach_range_(A, it, range2) if (it.ref) JOIN(A, push_back)(self, self->copy(it.ref));
+#ifdef POD
+        memcpy(ref, from, before * sizeof(T));
+        memcpy(&ref[before], after, (count - before) * sizeof(T));
+#else
+        for (size_t i = 0; i < before; i++)
+            ref[i] = self->copy(&from[i]);
+        for (size_t i = before; i < count; i++)
+            ref[i] = self->copy(&after[i - before]);
+#endif
     }
 #if defined CTL_STR
     JOIN(A, reserve)(self, self->size);
@@ -647,7 +825,7 @@ static inline void JOIN(A, insert_generic)(I *pos, GI *range)
     while (!done(range))
     {
         JOIN(A, insert)(pos, self->copy(ref(range)));
-        pos->ref = &self->vector[++index];
+        pos->ref = &_CTL_VEC_DATA(self)[++index];
         next(range);
     }
 }
@@ -661,50 +839,72 @@ static inline void JOIN(A, swap)(A *self, A *other)
     JOIN(A, shrink_to_fit)(self);
 }
 
-static inline void JOIN(A, _ranged_sort)(A *self, size_t a, size_t b, int _compare(T *, T *))
+#include <ctl/bits/sort.h>
+
+#if defined(POD) && !defined(NOT_INTEGRAL)
+// Sorts integral types ascending by their value, ignoring compare.
+static inline void JOIN(A, sort_radix)(A *self)
 {
-    if (UNLIKELY(a >= b))
-        return;
-    // TODO insertion_sort cutoff
-    // long mid = (a + b) / 2; // overflow!
-    // Dietz formula http://aggregate.org/MAGIC/#Average%20of%20Integers
-    size_t mid = ((a ^ b) >> 1) + (a & b);
-    // LOG("sort \"%s\" %ld, %ld\n", self->vector, a, b);
-    SWAP(T, &self->vector[a], &self->vector[mid]);
-    size_t z = a;
-    // check overflow of a + 1
-    if (LIKELY(a + 1 > a))
-        for (size_t i = a + 1; i <= b; i++)
-            if (_compare(&self->vector[i], &self->vector[a]))
-            {
-                z++;
-                SWAP(T, &self->vector[z], &self->vector[i]);
-            }
-    SWAP(T, &self->vector[a], &self->vector[z]);
-    if (LIKELY(z))
-        JOIN(A, _ranged_sort)(self, a, z - 1, _compare);
-    // check overflow of z + 1
-    if (LIKELY(z + 1 > z))
-        JOIN(A, _ranged_sort)(self, z + 1, b, _compare);
+    if (self->size > 1 && !JOIN(A, _radix_sort)(_CTL_VEC_DATA(self), self->size))
+        JOIN(A, _ranged_sort)(self, 0, self->size - 1, _JOIN(A, _default_integral_compare));
 }
+#endif
 
 static inline void JOIN(A, sort)(A *self)
 {
     CTL_ASSERT_COMPARE
-    // TODO insertion_sort cutoff
+#if defined(POD) && !defined(NOT_INTEGRAL) && !defined(COMPARE)
+    if (self->size > CTL_SORT_RADIX && self->compare == _JOIN(A, _default_integral_compare) &&
+        !JOIN(A, _radix_presorted)(_CTL_VEC_DATA(self), self->size) && JOIN(A, _radix_sort)(_CTL_VEC_DATA(self), self->size))
+        return;
+#endif
     if (self->size > 1)
         JOIN(A, _ranged_sort)(self, 0, self->size - 1, self->compare);
     //#ifdef CTL_STR
-    //    self->vector[self->size] = '\0';
+    //    _CTL_VEC_DATA(self)[self->size] = '\0';
     //#endif
 }
 
+static inline void JOIN(A, stable_sort)(A *self)
+{
+    CTL_ASSERT_COMPARE
+    JOIN(A, _stable_sort)(self, 0, self->size, self->compare);
+}
+
+static inline void JOIN(A, stable_sort_range)(I *range)
+{
+    A *self = range->container;
+    CTL_ASSERT_COMPARE
+    JOIN(A, _stable_sort)(self, JOIN(I, index)(range), range->end - JOIN(A, front)(self), self->compare);
+}
+
+#ifdef CTL_SORT_PARALLEL
+// Sorts with threads threads, 0 for CTL_SORT_THREADS or one per cpu. Small
+// vectors are sorted serially.
+static inline void JOIN(A, sort_parallel)(A *self, size_t threads)
+{
+    CTL_ASSERT_COMPARE
+    if (!JOIN(A, _sort_parallel)(self, self->size, self->compare, threads))
+        JOIN(A, sort)(self);
+}
+#endif
+
 static inline A JOIN(A, copy)(A *self)
 {
     A other = JOIN(A, init_from)(self);
-    JOIN(A, reserve)(&other, self->size); // i.e shrink to fit
+    if (self->size > other.capacity)
+        JOIN(A, fit)(&other, self->size); // i.e shrink to fit
+#ifdef POD
+    if (self->copy == JOIN(A, implicit_copy))
+    {
+        // the fresh storage is zeroed, with the \0 of strings
+        memcpy(_CTL_VEC_DATA(&other), _CTL_VEC_DATA(self), self->size * sizeof(T));
+        other.size = self->size;
+        return other;
+    }
+#endif
     while (other.size < self->size)
-        JOIN(A, push_back)(&other, other.copy(&self->vector[other.size]));
+        JOIN(A, push_back)(&other, other.copy(&_CTL_VEC_DATA(self)[other.size]));
     return other;
 }
 
@@ -715,7 +915,7 @@ static inline size_t JOIN(A, remove_if)(A *self, int (*_match)(T *))
         return 0;
     for (size_t i = 0; i < self->size;)
     {
-        if (_match(&self->vector[i]))
+        if (_match(&_CTL_VEC_DATA(self)[i]))
         {
             JOIN(A, erase_index)(self, i);
             erases++;
@@ -734,7 +934,14 @@ static inline size_t JOIN(A, erase_if)(A *self, int (*_match)(T *))
 #ifndef CTL_STR
 static inline I JOIN(A, find)(A *self, T key)
 {
-    vec_foreach(T, self, ref) if (JOIN(A, _equal)(self, ref, &key)) return JOIN(I, iter)(self, ref - &self->vector[0]);
+    T *vector = _CTL_VEC_DATA(self);
+#if defined(POD) && !defined(NOT_INTEGRAL)
+    if (JOIN(A, _simd)(self))
+        return JOIN(I, iter)(self, JOIN(A, _simd_find)(vector, self->size, key, true));
+#endif
+    for (size_t i = 0; i < self->size; i++)
+        if (JOIN(A, _equal)(self, &vector[i], &key))
+            return JOIN(I, iter)(self, i);
     return JOIN(A, end(self));
 }
 #endif
@@ -751,9 +958,9 @@ static inline A *JOIN(A, move_range)(I *range, A *out)
     {
         JOIN(A, push_back)(out, *ref);
         // erase without free
-        size_t index = ref - &self->vector[0];
+        size_t index = ref - &_CTL_VEC_DATA(self)[0];
         memmove(ref, ref + 1, (self->size - index - 1) * sizeof(T));
-        self->vector[self->size - 1] = zero;
+        _CTL_VEC_DATA(self)[self->size - 1] = zero;
         self->size--;
         ref++;
     }
@@ -775,6 +982,9 @@ static inline A *JOIN(A, move_range)(I *range, A *out)
 #undef I
 #undef MUST_ALIGN_16
 #undef INIT_SIZE
+#undef _CTL_VEC_MMAP
+#undef _CTL_VEC_DATA
+#undef _CTL_VEC_SMALL
 
 // Hold preserves `T` if other containers
 // (eg. `priority_queue.h`) wish to extend `vector.h`.
@@ -785,6 +995,13 @@ static inline A *JOIN(A, move_range)(I *range, A *out)
 #undef C
 #undef T
 #undef POD
+#undef COMPARE
+#undef EQUAL
+#undef CTL_ALLOC
+#undef CTL_REALLOC
+#undef CTL_FREE
+#undef _CTL_CALLOC
+#undef _CTL_ALLOC_DEFAULT
 #undef NOT_INTEGRAL
 #endif
 #undef CTL_VEC
@@ -120,7 +120,7 @@ deq_point astar(str *maze, int width)
             point delta = deltas[i];
             point next = point_init(current.x + delta.x, current.y + delta.y, width);
             int new_cost = set_pi_find(&costs, (pi){.p = current}).ref->i;
-            if (maze->vector[point_index(&next)] != '#')
+            if (str_c_str(maze)[point_index(&next)] != '#')
             {
                 set_pi_it cost = set_pi_find(&costs, (pi){.p = next});
                 if (set_pi_it_done(&cost) || new_cost < cost.ref->i)
@@ -175,7 +175,7 @@ int main(void)
     int width = str_find(&maze, "\n") + 1;
     deq_point path = astar(&maze, width);
     foreach (deq_point, &path, it)
-        maze.vector[point_index(it.ref)] = 'x';
+        str_c_str(&maze)[point_index(it.ref)] = 'x';
     printf("%s", str_c_str(&maze));
     str_free(&maze);
     deq_point_free(&path);
@@ -389,9 +389,8 @@ static valp get(valp value, char *s)
     if (is_object(value))
     {
         pair p;
-        p.string = str_init(s);
+        p.string = strview_key(strview_init(s));
         set_pair_node *node = set_pair_find_node(value->of.object, p);
-        str_free(&p.string);
         if (node)
             return node->value.value;
     }
@@ -416,9 +415,8 @@ static void erase_obj(valp value, char *string)
     if (is_object(value))
     {
         pair p;
-        p.string = str_init(string);
+        p.string = strview_key(strview_init(string));
         set_pair_erase(value->of.object, p);
-        str_free(&p.string);
     }
 }
 
@@ -68,7 +68,7 @@ int is_space(char c)
 str get_digit(str *s, size_t i)
 {
     size_t j = i;
-    while (is_digit(s->vector[j]))
+    while (is_digit(str_c_str(s)[j]))
         j++;
     return str_substr(s, i, j - i);
 }
@@ -76,7 +76,7 @@ str get_digit(str *s, size_t i)
 str get_operator(str *s, size_t i)
 {
     size_t j = i;
-    while (is_of_operator(s->vector[j]))
+    while (is_of_operator(str_c_str(s)[j]))
         j++;
     return str_substr(s, i, j - i);
 }
@@ -86,7 +86,7 @@ ls tokenize(str *s)
     ls tokens = ls_init();
     for (size_t i = 0; i < s->size; i++)
     {
-        char c = s->vector[i];
+        char c = str_c_str(s)[i];
         if (is_space(c))
             continue;
         str token;
@@ -114,7 +114,7 @@ ls to_postfix(ls *tokens)
     foreach (ls, tokens, it)
     {
         str *token = it.ref;
-        char c = token->vector[0];
+        char c = str_c_str(token)[0];
         if (is_digit(c))
         {
             ls_push_back(&postfix, str_copy(token));
@@ -123,11 +123,11 @@ ls to_postfix(ls *tokens)
                 if (it.node->next)
                 {
                     str *next = &it.node->next->value;
-                    char cc = next->vector[0];
+                    char cc = str_c_str(next)[0];
                     if (get_prec(c) < get_prec(cc))
                     {
                         str *operator= ss_top(&operators);
-                        char ccc = operator->vector[0];
+                        char ccc = str_c_str(operator)[0];
                         if (ccc != '(')
                         {
                             ls_push_back(&postfix, str_copy(operator));
@@ -149,7 +149,7 @@ ls to_postfix(ls *tokens)
                 while (!done)
                 {
                     str *top = ss_top(&operators);
-                    char cc = top->vector[0];
+                    char cc = str_c_str(top)[0];
                     if (cc == '(')
                         done = 1;
                     else
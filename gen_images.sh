@@ -4,7 +4,7 @@ CXX="g++ -std=c++17"
 CFLAGS="-O3 -march=native -I."
 VERSION=$($CXX --version | head -1)
 if test -z "$PNG"; then
-  PNG="uset uset_pow2 uset_cached _set pqu vec slist list deq arr compile"
+  PNG="uset uset_find uset_pow2 uset_cached uset_pool swiss hmap _set pqu vec vec_sort svec slist list deq arr compile"
 fi
 
 perf_graph()
@@ -78,6 +78,15 @@ uset() {
      tests/perf/uset/perf_uset_iterate.c"
 }
 
+uset_find() {
+  perf_graph \
+    'uset_find.log' \
+    "std::unordered_set<int> find vs. CTL uset_int contains and contains_batch ($CFLAGS) ($VERSION)" \
+    "tests/perf/uset/perf_uset_find.cc \
+     tests/perf/uset/perf_uset_find.c \
+     tests/perf/uset/perf_uset_find_batch.c"
+}
+
 uset_pow2() {
   ORIG_CFLAGS="$CFLAGS"
   CFLAGS="$CFLAGS -DCTL_USET_GROWTH_POWER2"
@@ -108,6 +117,49 @@ uset_cached() {
   CFLAGS="$ORIG_CFLAGS"
 }
 
+uset_pool() {
+  ORIG_CFLAGS="$CFLAGS"
+  CFLAGS="$CFLAGS -DCTL_USET_NODE_POOL"
+  perf_graph \
+    'uset_pool.log' \
+    "std::unordered_set<int> (dotted) vs. CTL uset_int NODE_POOL (solid) ($CFLAGS) ($VERSION)" \
+    "tests/perf/uset/perf_uset_insert.cc \
+     tests/perf/uset/perf_uset_insert.c \
+     tests/perf/uset/perf_uset_erase.cc \
+     tests/perf/uset/perf_uset_erase.c
+     tests/perf/uset/perf_uset_iterate.cc \
+     tests/perf/uset/perf_uset_iterate.c"
+  CFLAGS="$ORIG_CFLAGS"
+}
+
+swiss() {
+  perf_graph \
+    'swiss.log' \
+    "std::unordered_set<int> (dotted) vs. CTL swiss_int (solid) ($CFLAGS) ($VERSION)" \
+    "tests/perf/uset/perf_uset_insert.cc \
+     tests/perf/uset/perf_swiss_insert.c \
+     tests/perf/uset/perf_uset_find.cc \
+     tests/perf/uset/perf_swiss_find.c \
+     tests/perf/uset/perf_uset_erase.cc \
+     tests/perf/uset/perf_swiss_erase.c \
+     tests/perf/uset/perf_uset_iterate.cc \
+     tests/perf/uset/perf_swiss_iterate.c"
+}
+
+hmap() {
+  perf_graph \
+    'hmap.log' \
+    "std::unordered_set<int> (dotted) vs. CTL hmap_int (solid) ($CFLAGS) ($VERSION)" \
+    "tests/perf/uset/perf_uset_insert.cc \
+     tests/perf/uset/perf_hmap_insert.c \
+     tests/perf/uset/perf_uset_find.cc \
+     tests/perf/uset/perf_hmap_find.c \
+     tests/perf/uset/perf_uset_erase.cc \
+     tests/perf/uset/perf_hmap_erase.c \
+     tests/perf/uset/perf_uset_iterate.cc \
+     tests/perf/uset/perf_hmap_iterate.c"
+}
+
 _set() {
   perf_graph \
     'set.log' \
@@ -145,7 +197,36 @@ vec() {
      tests/perf/vec/perf_vector_sort.cc \
      tests/perf/vec/perf_vec_sort.c \
      tests/perf/vec/perf_vector_iterate.cc \
-     tests/perf/vec/perf_vec_iterate.c"
+     tests/perf/vec/perf_vec_iterate.c \
+     tests/perf/vec/perf_vector_stable_sort.cc \
+     tests/perf/vec/perf_vec_stable_sort.c \
+     tests/perf/vec/perf_vector_insert_range.cc \
+     tests/perf/vec/perf_vec_insert_range.c \
+     tests/perf/vec/perf_vector_erase_range.cc \
+     tests/perf/vec/perf_vec_erase_range.c \
+     tests/perf/vec/perf_vector_clear.cc \
+     tests/perf/vec/perf_vec_clear.c \
+     tests/perf/vec/perf_vector_find.cc \
+     tests/perf/vec/perf_vec_find.c"
+}
+
+svec() {
+  perf_graph \
+    'svec.log' \
+    "std::vector<int> (dotted) vs. CTL vec_int and svec8_int (solid) ($CFLAGS) ($VERSION)" \
+    "tests/perf/vec/perf_vector_tiny.cc \
+     tests/perf/vec/perf_vec_tiny.c \
+     tests/perf/vec/perf_svec_tiny.c"
+}
+
+vec_sort() {
+  perf_graph \
+    'vec_sort.log' \
+    "std::sort (dotted) vs. CTL vec_int_sort default and COMPARE (solid) ($CFLAGS) ($VERSION)" \
+    "tests/perf/vec/perf_vector_sort.cc \
+     tests/perf/vec/perf_vec_sort.c \
+     tests/perf/vec/perf_vector_sort.cc \
+     tests/perf/vec/perf_vec_sort_compare.c"
 }
 
 str() {
@@ -159,7 +240,45 @@ str() {
      tests/perf/str/perf_string_sort.cc \
      tests/perf/str/perf_str_sort.c \
      tests/perf/str/perf_string_iterate.cc \
-     tests/perf/str/perf_str_iterate.c"
+     tests/perf/str/perf_str_iterate.c \
+     tests/perf/str/perf_string_short.cc \
+     tests/perf/str/perf_str_short.c"
+}
+
+str_edit() {
+  perf_graph \
+    'str_edit.log' \
+    "std::string (dotted) vs. CTL str (solid) append, insert_str, replace ($CFLAGS) ($VERSION)" \
+    "tests/perf/str/perf_string_append.cc \
+     tests/perf/str/perf_str_append.c \
+     tests/perf/str/perf_string_insert.cc \
+     tests/perf/str/perf_str_insert.c \
+     tests/perf/str/perf_string_replace.cc \
+     tests/perf/str/perf_str_replace.c"
+}
+
+str_find() {
+  perf_graph \
+    'str_find.log' \
+    "std::string (dotted) vs. CTL str (solid) find, rfind, searcher, view lookup ($CFLAGS) ($VERSION)" \
+    "tests/perf/str/perf_string_find.cc \
+     tests/perf/str/perf_str_find.c \
+     tests/perf/str/perf_string_rfind.cc \
+     tests/perf/str/perf_str_rfind.c \
+     tests/perf/str/perf_string_searcher.cc \
+     tests/perf/str/perf_str_searcher.c \
+     tests/perf/str/perf_string_lookup.cc \
+     tests/perf/str/perf_str_lookup.c"
+}
+
+str_find_of() {
+  perf_graph \
+    'str_find_of.log' \
+    "std::string (dotted) vs. CTL str (solid) find_first_of and friends, tokenize ($CFLAGS) ($VERSION)" \
+    "tests/perf/str/perf_string_find_of.cc \
+     tests/perf/str/perf_str_find_of.c \
+     tests/perf/str/perf_string_tokenize.cc \
+     tests/perf/str/perf_str_tokenize.c"
 }
 
 slist() {
@@ -208,7 +327,9 @@ deq() {
      tests/perf/deq/perf_deque_sort.cc \
      tests/perf/deq/perf_deq_sort.c \
      tests/perf/deq/perf_deque_iterate.cc \
-     tests/perf/deq/perf_deq_iterate.c"
+     tests/perf/deq/perf_deq_iterate.c \
+     tests/perf/deq/perf_deque_stable_sort.cc \
+     tests/perf/deq/perf_deq_stable_sort.c"
 # removed the one most boring:
 #    tests/perf/deq/perf_deque_push_front.cc
 #    tests/perf/deq/perf_deq_push_front.c
@@ -47,6 +47,13 @@ digi_copy(digi* self)
     return copy;
 }
 
+// by the low 4 bits only, to see the order of equal elements in stable sorts
+static inline int
+digi_compare_low(digi* a, digi* b)
+{
+    return (*a->value & 15) < (*b->value & 15);
+}
+
 static inline int
 digi_is_odd(digi* d)
 {
@@ -183,6 +190,12 @@ DIGI_compare3(DIGI& a, DIGI& b)
   return *a.value < *b.value ? -1 : *a.value == *b.value ? 0 : 1;
 }
 
+static inline bool
+DIGI_compare_low(const DIGI& a, const DIGI& b)
+{
+    return (*a.value & 15) < (*b.value & 15);
+}
+
 static inline bool
 DIGI_is_odd(DIGI& d)
 {
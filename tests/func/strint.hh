@@ -52,7 +52,7 @@ strint_compare(strint* a, strint* b)
 static inline size_t
 strint_hash(strint* a)
 {
-    const char* key = a->key.vector;
+    const char* key = str_c_str(&a->key);
     return key && *key ? (size_t)FNV1a(key) : 0UL;
 }
 
@@ -68,7 +68,7 @@ strint_copy(strint* self)
 static inline int
 strint_isupper(strint* d)
 {
-    return isupper(d->key.vector[0]);
+    return isupper(str_c_str(&d->key)[0]);
 }
 
 static inline int
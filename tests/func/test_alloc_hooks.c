@@ -0,0 +1,130 @@
+// Test the CTL_ALLOC hooks, the vector growth factor and the mmap path.
+#define _GNU_SOURCE
+#define CTL_VEC_GROWTH_FACTOR 1.5
+#define CTL_VEC_MMAP 65536
+#include "../test.h"
+
+// a counting allocator
+static long allocs, frees;
+
+static void *count_alloc(size_t size)
+{
+    allocs++;
+    return malloc(size);
+}
+
+static void *count_realloc(void *ptr, size_t size)
+{
+    if (!ptr)
+        allocs++;
+    return realloc(ptr, size);
+}
+
+static void count_free(void *ptr)
+{
+    if (ptr)
+        frees++;
+    free(ptr);
+}
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#include <ctl/string.h>
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#define POD
+#define T int
+#include <ctl/deque.h>
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#define POD
+#define T int
+#include <ctl/list.h>
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#define POD
+#define T int
+#include <ctl/set.h>
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) count_realloc(ptr, size)
+#define CTL_FREE(ptr) count_free(ptr)
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#ifdef CTL_ALLOC
+#error "CTL_ALLOC leftover"
+#endif
+
+// without hooks: mmap'ed above 64KB
+typedef long lng;
+#define POD
+#define T lng
+#include <ctl/vector.h>
+
+#define SIZE 100000
+
+int main(void)
+{
+    INIT_SRAND;
+    vec_int v = vec_int_init();
+    str s = str_init("");
+    deq_int d = deq_int_init();
+    list_int l = list_int_init();
+    set_int t = set_int_init(NULL);
+    uset_int u = uset_int_init(NULL, NULL);
+    size_t last = 0;
+    for (int i = 0; i < SIZE; i++)
+    {
+        vec_int_push_back(&v, i);
+        if (v.capacity != last)
+        {
+            // grows by 1.5
+            assert(!last || v.capacity == last + last / 2 || v.capacity == last + 1);
+            last = v.capacity;
+        }
+        str_push_back(&s, 'a' + i % 26);
+        deq_int_push_back(&d, i);
+        list_int_push_back(&l, i);
+        set_int_insert(&t, rand() % 1000);
+        uset_int_insert(&u, rand() % 1000);
+    }
+    assert(allocs > 0);
+    vec_int_free(&v);
+    str_free(&s);
+    deq_int_free(&d);
+    list_int_free(&l);
+    set_int_free(&t);
+    uset_int_free(&u);
+    assert(allocs == frees);
+
+    vec_lng w = vec_lng_init();
+    for (long i = 0; i < SIZE; i++)
+        vec_lng_push_back(&w, i);
+    for (long i = 0; i < SIZE; i++)
+        assert(w.vector[i] == i);
+    // back to malloc, and up again
+    vec_lng_resize(&w, 100, 0);
+    vec_lng_shrink_to_fit(&w);
+    for (long i = 0; i < 100; i++)
+        assert(w.vector[i] == i);
+    vec_lng_resize(&w, SIZE, 7);
+    assert(w.vector[99] == 99 && w.vector[SIZE - 1] == 7);
+    vec_lng_free(&w);
+    TEST_PASS(__FILE__);
+}
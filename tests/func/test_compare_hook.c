@@ -0,0 +1,125 @@
+// Test the compile-time COMPARE and EQUAL hooks, without compare methods.
+#include "../test.h"
+
+typedef struct
+{
+    int x;
+    int y;
+} point;
+
+// descending by x, to differ from any default
+#define POD
+#define NOT_INTEGRAL
+#define COMPARE(a, b) ((a)->x > (b)->x)
+#define EQUAL(a, b) ((a)->x == (b)->x)
+#define T point
+#include <ctl/vector.h>
+
+#ifdef COMPARE
+#error "COMPARE leftover"
+#endif
+
+#define POD
+#define NOT_INTEGRAL
+#define COMPARE(a, b) ((a)->x > (b)->x)
+#define T point
+#include <ctl/deque.h>
+
+#define POD
+#define NOT_INTEGRAL
+#define COMPARE(a, b) ((a)->x < (b)->x)
+#define T point
+#include <ctl/priority_queue.h>
+
+#define POD
+#define NOT_INTEGRAL
+#define COMPARE(a, b) ((a)->x < (b)->x)
+#define T point
+#include <ctl/set.h>
+
+#define POD
+#define COMPARE(a, b) (*(a) > *(b))
+#define T int
+#define N 64
+#include <ctl/array.h>
+
+// and the default integral compare method
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+static int int_greater(int *a, int *b)
+{
+    return *a > *b;
+}
+
+#define SIZE 1000
+
+int main(void)
+{
+    INIT_SRAND;
+    vec_point v = vec_point_init();
+    deq_point d = deq_point_init();
+    pqu_point p = pqu_point_init(NULL);
+    set_point s = set_point_init(NULL);
+    arr64_int a = arr64_int_init();
+    for (int i = 0; i < SIZE; i++)
+    {
+        point pt = {rand() % 100, i};
+        vec_point_push_back(&v, pt);
+        deq_point_push_back(&d, pt);
+        pqu_point_push(&p, pt);
+        set_point_insert(&s, pt);
+        if (i < 64)
+            a.vector[i] = pt.x;
+    }
+    vec_point_sort(&v);
+    deq_point_sort(&d);
+    arr64_int_sort(&a);
+    for (int i = 1; i < SIZE; i++)
+    {
+        assert(v.vector[i - 1].x >= v.vector[i].x);
+        assert(deq_point_at(&d, i - 1)->x >= deq_point_at(&d, i)->x);
+        if (i < 64)
+            assert(a.vector[i - 1] >= a.vector[i]);
+    }
+    int last = 100;
+    while (!pqu_point_empty(&p))
+    {
+        assert(pqu_point_top(&p)->x <= last);
+        last = pqu_point_top(&p)->x;
+        pqu_point_pop(&p);
+    }
+    // only unique x in the set, ascending
+    last = -1;
+    foreach (set_point, &s, it)
+    {
+        assert(it.ref->x > last);
+        last = it.ref->x;
+    }
+    point key = {v.vector[0].x, -1};
+    vec_point_it found = vec_point_find(&v, key);
+    assert(!vec_point_it_done(&found));
+    assert(set_point_contains(&s, key));
+    key.x = 100;
+    assert(!set_point_contains(&s, key));
+    vec_point_free(&v);
+    deq_point_free(&d);
+    pqu_point_free(&p);
+    set_point_free(&s);
+
+    // a runtime compare method overrides the inlined default
+    vec_int i = vec_int_init();
+    for (int j = 0; j < SIZE; j++)
+        vec_int_push_back(&i, rand());
+    vec_int_sort(&i);
+    for (int j = 1; j < SIZE; j++)
+        assert(i.vector[j - 1] <= i.vector[j]);
+    i.compare = int_greater;
+    vec_int_sort(&i);
+    for (int j = 1; j < SIZE; j++)
+        assert(i.vector[j - 1] >= i.vector[j]);
+    vec_int_free(&i);
+
+    TEST_PASS(__FILE__);
+}
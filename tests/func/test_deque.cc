@@ -42,6 +42,8 @@ OLD_MAIN
     TEST(SORT)                                                                                                         \
     TEST(RANGED_SORT)                                                                                                  \
     TEST(SORT_RANGE)                                                                                                   \
+    TEST(STABLE_SORT)                                                                                                  \
+    TEST(STABLE_SORT_RANGE)                                                                                            \
     TEST(COPY)                                                                                                         \
     TEST(SWAP)                                                                                                         \
     TEST(ASSIGN)                                                                                                       \
@@ -662,6 +664,23 @@ int main(void)
                 CHECK(a, b);
                 break;
             }
+            case TEST_STABLE_SORT: {
+                a.compare = digi_compare_low;
+                deq_digi_stable_sort(&a);
+                a.compare = digi_compare;
+                std::stable_sort(b.begin(), b.end(), DIGI_compare_low);
+                CHECK(a, b);
+                break;
+            }
+            case TEST_STABLE_SORT_RANGE: {
+                get_random_iters(&a, &range_a1, b, first_b1, last_b1);
+                a.compare = digi_compare_low;
+                deq_digi_stable_sort_range(&range_a1);
+                a.compare = digi_compare;
+                std::stable_sort(first_b1, last_b1, DIGI_compare_low);
+                CHECK(a, b);
+                break;
+            }
             case TEST_COPY: {
                 aa = deq_digi_copy(&a);
                 bb = b;
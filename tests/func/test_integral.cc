@@ -1,5 +1,6 @@
 /* See if all known integral types can use default compare, equal methods */
 #include "../test.h"
+#include <math.h>
 
 #define POD
 #define T int
@@ -88,6 +89,14 @@ typedef unsigned long ulong;
 #define T long
 #include <ctl/unordered_set.h>
 
+#define POD
+#define T double
+#include <ctl/unordered_set.h>
+
+#define POD
+#define T long_double
+#include <ctl/unordered_set.h>
+
 #define POD
 #define N 128
 #define T int
@@ -147,6 +156,29 @@ int main(void)
         assert(!uset_long_it_done(&found));          // equal
         uset_long_free(&a);
     }
+    {
+        // hashed by the bits, not truncated to the same integer
+        uset_double a = uset_double_init(NULL, NULL);
+        uset_long_double b = uset_long_double_init(NULL, NULL);
+        for (int i = 0; i < 1000; i++)
+        {
+            uset_double_insert(&a, i / 1000.0);
+            uset_long_double_insert(&b, i / 1000.0L);
+        }
+        uset_double_insert(&a, -0.0);
+        uset_long_double_insert(&b, -0.0L);
+        assert(uset_double_size(&a) == 1000);
+        assert(uset_long_double_size(&b) == 1000);
+        double d1 = 0.5, d2 = 0.501;
+        assert(a.hash(&d1) != a.hash(&d2));
+        long double ld1 = 0.5L, ld2 = 0.501L;
+        assert(b.hash(&ld1) != b.hash(&ld2));
+        assert(uset_double_contains(&a, -0.0));
+        assert(uset_double_count(&a, INFINITY) == 0);
+        assert(uset_double_count(&a, NAN) == 0);
+        uset_double_free(&a);
+        uset_long_double_free(&b);
+    }
     {
         arr128_int a = arr128_int_init();
         for (int i = 0; i < 127; i++)
@@ -0,0 +1,101 @@
+// Test the radix sort of the integral vectors and arrays against the pdqsort.
+#include "../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#define POD
+#define T uint64_t
+#include <ctl/vector.h>
+
+#define POD
+#define T int8_t
+#include <ctl/vector.h>
+
+#define POD
+#define T short
+#include <ctl/vector.h>
+
+#define POD
+#define T float
+#include <ctl/vector.h>
+
+#define POD
+#define T double
+#include <ctl/vector.h>
+
+#define POD
+#define T long
+#define N 5000
+#include <ctl/array.h>
+
+// pointers compare by address, but are not radix sorted
+typedef int *intp;
+#define POD
+#define T intp
+#include <ctl/vector.h>
+
+#define SIZE 10000
+
+// random with negatives and the full bit range
+static uint64_t random64(void)
+{
+    return (uint64_t)rand() << 42 ^ (uint64_t)rand() << 21 ^ (uint64_t)rand();
+}
+
+#define TEST_RADIX(A, T, value)                                                                                        \
+    {                                                                                                                  \
+        A a = JOIN(A, init)();                                                                                         \
+        A b = JOIN(A, init)();                                                                                         \
+        for (int i = 0; i < SIZE; i++)                                                                                 \
+        {                                                                                                              \
+            T v = value;                                                                                               \
+            JOIN(A, push_back)(&a, v);                                                                                 \
+            JOIN(A, push_back)(&b, v);                                                                                 \
+        }                                                                                                              \
+        JOIN(A, sort_radix)(&a);                                                                                       \
+        JOIN(A, _ranged_sort)(&b, 0, SIZE - 1, b.compare);                                                             \
+        assert(!memcmp(a.vector, b.vector, SIZE * sizeof(T)));                                                         \
+        /* sort picks it */                                                                                            \
+        for (int i = 0; i < SIZE; i++)                                                                                 \
+            a.vector[i] = b.vector[SIZE - 1 - i];                                                                      \
+        JOIN(A, sort)(&a);                                                                                             \
+        assert(!memcmp(a.vector, b.vector, SIZE * sizeof(T)));                                                         \
+        JOIN(A, free)(&a);                                                                                             \
+        JOIN(A, free)(&b);                                                                                             \
+    }
+
+int main(void)
+{
+    INIT_SRAND;
+    TEST_RADIX(vec_int, int, (int)random64());
+    TEST_RADIX(vec_int, int, rand() % 100); // skips the upper digits
+    TEST_RADIX(vec_uint64_t, uint64_t, random64());
+    TEST_RADIX(vec_int8_t, int8_t, (int8_t)rand());
+    TEST_RADIX(vec_short, short, (short)rand());
+    TEST_RADIX(vec_float, float, (float)((int)random64()) / 1000.0f);
+    TEST_RADIX(vec_double, double, (double)(int64_t)random64() / 3.0);
+
+    arr5000_long a = arr5000_long_init();
+    arr5000_long b = arr5000_long_init();
+    for (int i = 0; i < 5000; i++)
+        a.vector[i] = b.vector[i] = (long)random64();
+    arr5000_long_sort(&a);
+    arr5000_long__ranged_sort(&b, 0, 4999, b.compare);
+    assert(!memcmp(a.vector, b.vector, 5000 * sizeof(long)));
+    arr5000_long_free(&a);
+    arr5000_long_free(&b);
+
+    static int ints[SIZE];
+    vec_intp p = vec_intp_init();
+    assert(!vec_intp__radix_sortable());
+    for (int i = 0; i < SIZE; i++)
+        vec_intp_push_back(&p, &ints[TEST_RAND(SIZE)]);
+    vec_intp_sort(&p);
+    for (int i = 1; i < SIZE; i++)
+        assert(!(p.vector[i] < p.vector[i - 1]));
+    vec_intp_free(&p);
+
+    TEST_PASS(__FILE__);
+}
@@ -0,0 +1,167 @@
+// Concurrent inserts, finds, erases and foreach_parallel on a sharded map
+#include "../test.h"
+
+#include <pthread.h>
+
+typedef struct
+{
+    int key;
+    int value;
+} intint;
+
+static size_t intint_hash(intint *a) { return (size_t)a->key; }
+static int intint_equal(intint *a, intint *b) { return a->key == b->key; }
+
+#define POD
+#define NOT_INTEGRAL
+#define T intint
+#include <ctl/sharded_map.h>
+
+// with owned keys, for the frees on assign and erase
+typedef struct
+{
+    char *key;
+    int value;
+} charint;
+
+static char *str_dup(const char *s)
+{
+    char *copy = (char *)malloc(strlen(s) + 1);
+    strcpy(copy, s);
+    return copy;
+}
+
+static size_t charint_hash(charint *a) { return ctl_hash_str(a->key); }
+static int charint_equal(charint *a, charint *b) { return strcmp(a->key, b->key) == 0; }
+static void charint_free(charint *a) { free(a->key); }
+static charint charint_copy(charint *a)
+{
+    charint copy = {str_dup(a->key), a->value};
+    return copy;
+}
+static charint charint_init(int i, int value)
+{
+    char buf[16];
+    snprintf(buf, sizeof buf, "%d", i);
+    charint self = {str_dup(buf), value};
+    return self;
+}
+
+#define T charint
+#include <ctl/sharded_map.h>
+
+#define THREADS 8
+#define KEYS 20000
+
+static shmap_intint m;
+static shmap_charint s;
+
+static intint ii(int key, int value)
+{
+    intint self = {key, value};
+    return self;
+}
+
+// all threads assign all keys: the value is one of them
+static void *producer(void *arg)
+{
+    const int t = (int)(intptr_t)arg;
+    for (int i = 0; i < KEYS; i++)
+    {
+        const int key = (i * 7 + t * 1013) % KEYS;
+        shmap_intint_insert_or_assign(&m, ii(key, key * THREADS + t));
+        shmap_charint_insert_or_assign(&s, charint_init(key, t));
+    }
+    return NULL;
+}
+
+// the even threads erase the odd keys, the odd threads find the even keys
+static void *eraser_finder(void *arg)
+{
+    const int t = (int)(intptr_t)arg;
+    for (int i = t & 1 ? 0 : 1; i < KEYS; i += 2)
+    {
+        if (t & 1)
+        {
+            intint found;
+            assert(shmap_intint_find(&m, ii(i, 0), &found));
+            assert(found.key == i && found.value / THREADS == i);
+            charint key = charint_init(i, 0);
+            charint cfound;
+            assert(shmap_charint_find(&s, key, &cfound));
+            assert(strcmp(cfound.key, key.key) == 0 && cfound.value < THREADS);
+            charint_free(&cfound);
+            charint_free(&key);
+        }
+        else
+        {
+            shmap_intint_erase(&m, ii(i, 0));
+            charint key = charint_init(i, 0);
+            shmap_charint_erase(&s, key);
+            charint_free(&key);
+        }
+    }
+    return NULL;
+}
+
+static pthread_mutex_t sum_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void sum_keys(intint *v, void *arg)
+{
+    v->value = -v->key; // the values may be changed
+    pthread_mutex_lock(&sum_lock);
+    *(long *)arg += v->key;
+    pthread_mutex_unlock(&sum_lock);
+}
+
+static void run(void *(*fn)(void *))
+{
+    pthread_t tids[THREADS];
+    for (int t = 0; t < THREADS; t++)
+        assert(pthread_create(&tids[t], NULL, fn, (void *)(intptr_t)t) == 0);
+    for (int t = 0; t < THREADS; t++)
+        pthread_join(tids[t], NULL);
+}
+
+int main(void)
+{
+    m = shmap_intint_init(intint_hash, intint_equal);
+    s = shmap_charint_init_shards(charint_hash, charint_equal, 5);
+    run(producer);
+    assert(shmap_intint_size(&m) == KEYS);
+    assert(shmap_charint_size(&s) == KEYS);
+    for (int i = 0; i < KEYS; i++)
+    {
+        intint found;
+        assert(shmap_intint_find(&m, ii(i, 0), &found));
+        assert(found.value / THREADS == i);
+    }
+    // a single assign
+    assert(!shmap_intint_insert_or_assign(&m, ii(0, THREADS - 1)));
+    assert(shmap_intint_insert_or_assign(&m, ii(KEYS, 0)));
+    shmap_intint_erase(&m, ii(KEYS, 0));
+    assert(!shmap_intint_contains(&m, ii(KEYS, 0)));
+
+    run(eraser_finder);
+    assert(shmap_intint_size(&m) == KEYS / 2);
+    assert(shmap_charint_size(&s) == KEYS / 2);
+
+    long sum = 0;
+    shmap_intint_foreach_parallel(&m, sum_keys, &sum, 4);
+    assert(sum == (long)(KEYS / 2) * (KEYS / 2 - 1)); // the even keys
+    for (int i = 0; i < KEYS; i += 2)
+    {
+        intint found;
+        assert(shmap_intint_find(&m, ii(i, 0), &found));
+        assert(found.value == -i);
+    }
+    sum = 0;
+    shmap_intint_foreach_parallel(&m, sum_keys, &sum, 0);
+    assert(sum == (long)(KEYS / 2) * (KEYS / 2 - 1));
+
+    shmap_intint_clear(&m);
+    assert(shmap_intint_empty(&m));
+    shmap_intint_free(&m);
+    shmap_charint_free(&s);
+    TEST_PASS(__FILE__);
+}
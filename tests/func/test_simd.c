@@ -0,0 +1,151 @@
+// Test the SIMD find, count and mismatch of the integral vectors and arrays
+// against plain loops, over all register tails.
+#include "../test.h"
+
+#define POD
+#define T uint8_t
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T short
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T int
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T int64_t
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T float
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T double
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T int
+#define N 100
+#define INCLUDE_ALGORITHM
+#include <ctl/array.h>
+
+// pointers are no SIMD type, but compile and compare by address
+typedef int *intp;
+#define POD
+#define T intp
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#define POD
+#define T intp
+#define N 4
+#define INCLUDE_ALGORITHM
+#include <ctl/array.h>
+
+#include <math.h>
+
+#define SIZE 200
+
+// few values, to find and count many
+#define TEST_SIMD(A, T, value)                                                                                         \
+    for (size_t size = 0; size < SIZE; size++)                                                                         \
+    {                                                                                                                  \
+        A a = JOIN(A, init)();                                                                                         \
+        for (size_t i = 0; i < size; i++)                                                                              \
+            JOIN(A, push_back)(&a, (T)(value));                                                                        \
+        A b = JOIN(A, copy)(&a);                                                                                       \
+        const T key = (T)(value);                                                                                      \
+        size_t first = size, count = 0;                                                                                \
+        for (size_t i = 0; i < size; i++)                                                                              \
+            if (a.vector[i] == key)                                                                                    \
+            {                                                                                                          \
+                if (first == size)                                                                                     \
+                    first = i;                                                                                         \
+                count++;                                                                                               \
+            }                                                                                                          \
+        JOIN(A, it) it = JOIN(A, find)(&a, key);                                                                       \
+        assert(JOIN(JOIN(A, it), index)(&it) == first);                                                                \
+        assert(JOIN(A, count)(&a, key) == count);                                                                      \
+        JOIN(A, it) range = JOIN(A, begin)(&a);                                                                        \
+        assert(JOIN(A, find_range)(&range, key) == (first < size));                                                    \
+        range = JOIN(A, begin)(&a);                                                                                    \
+        assert(JOIN(A, equal_value)(&range, key) == (size && count == size));                                          \
+        assert(JOIN(A, equal)(&a, &b));                                                                                \
+        if (size)                                                                                                      \
+        {                                                                                                              \
+            const size_t diff = TEST_RAND(size);                                                                       \
+            b.vector[diff] = (T)(b.vector[diff] + 1);                                                                  \
+            assert(!JOIN(A, equal)(&a, &b));                                                                           \
+            JOIN(A, it) r1 = JOIN(A, begin)(&a);                                                                       \
+            JOIN(A, it) r2 = JOIN(A, begin)(&b);                                                                       \
+            assert(JOIN(A, mismatch)(&r1, &r2));                                                                       \
+            assert(JOIN(JOIN(A, it), index)(&r1) == diff);                                                             \
+            assert(JOIN(JOIN(A, it), index)(&r2) == diff);                                                             \
+            r1 = JOIN(A, begin)(&a);                                                                                   \
+            r2 = JOIN(A, begin)(&b);                                                                                   \
+            assert(!JOIN(A, equal_range)(&r1, &r2));                                                                   \
+        }                                                                                                              \
+        JOIN(A, free)(&a);                                                                                             \
+        JOIN(A, free)(&b);                                                                                             \
+    }
+
+int main(void)
+{
+    INIT_SRAND;
+    TEST_SIMD(vec_uint8_t, uint8_t, rand() % 4);
+    TEST_SIMD(vec_short, short, rand() % 4 - 2);
+    TEST_SIMD(vec_int, int, rand() % 4 - 2);
+    TEST_SIMD(vec_int64_t, int64_t, (int64_t)(rand() % 4) << 32 | (rand() % 2));
+    TEST_SIMD(vec_float, float, (rand() % 4) / 2.0f);
+    TEST_SIMD(vec_double, double, (rand() % 4) / 2.0);
+    static int ints[4];
+    TEST_SIMD(vec_intp, intp, &ints[rand() % 4]);
+
+    // NaN never equal, -0.0 equals 0.0
+    vec_double d = vec_double_init();
+    for (int i = 0; i < 40; i++)
+        vec_double_push_back(&d, i == 20 ? -0.0 : NAN);
+    vec_double_it it = vec_double_find(&d, NAN);
+    assert(vec_double_it_done(&it));
+    it = vec_double_find(&d, 0.0);
+    assert(vec_double_it_index(&it) == 20);
+    assert(vec_double_count(&d, NAN) == 0);
+    vec_double dd = vec_double_copy(&d);
+    assert(!vec_double_equal(&d, &dd));
+    vec_double_free(&d);
+    vec_double_free(&dd);
+
+    arr100_int a = arr100_int_init();
+    for (int i = 0; i < 100; i++)
+        a.vector[i] = i % 50;
+    assert(arr100_int_find(&a, 49) == &a.vector[49]);
+    assert(arr100_int_find(&a, 50) == NULL);
+    assert(arr100_int_count(&a, 7) == 2);
+    arr100_int aa = arr100_int_copy(&a);
+    assert(arr100_int_equal(&a, &aa));
+    aa.vector[99] = 0;
+    assert(!arr100_int_equal(&a, &aa));
+    arr100_int_free(&a);
+    arr100_int_free(&aa);
+
+    arr4_intp p = arr4_intp_init();
+    arr4_intp_fill(&p, &ints[1]);
+    p.vector[3] = &ints[2];
+    assert(arr4_intp_find(&p, &ints[2]) == &p.vector[3]);
+    assert(arr4_intp_count(&p, &ints[1]) == 3);
+    arr4_intp pp = arr4_intp_copy(&p);
+    assert(arr4_intp_equal(&p, &pp));
+    arr4_intp_free(&p);
+    arr4_intp_free(&pp);
+
+    TEST_PASS(__FILE__);
+}
@@ -0,0 +1,274 @@
+#include "../test.h"
+#if __cplusplus < 201103L
+#pragma warning "Can only test against C++11 compilers"
+OLD_MAIN
+#else
+
+#include "digi.hh"
+
+#define T digi
+#define N 8
+#include <ctl/small_vector.h>
+
+// over-aligned, for the inline elements of vec_foreach
+typedef long double ldbl;
+#define POD
+#define T ldbl
+#define N 4
+#include <ctl/small_vector.h>
+
+#include <algorithm>
+#include <vector>
+
+#define TEST_MAX_VALUE 15
+
+#define FOREACH_METH(TEST)                                                                                             \
+    TEST(PUSH_BACK)                                                                                                    \
+    TEST(POP_BACK)                                                                                                     \
+    TEST(CLEAR)                                                                                                        \
+    TEST(ERASE_INDEX)                                                                                                  \
+    TEST(ERASE_RANGE)                                                                                                  \
+    TEST(INSERT_INDEX)                                                                                                 \
+    TEST(INSERT_COUNT)                                                                                                 \
+    TEST(INSERT_RANGE_SELF)                                                                                            \
+    TEST(RESIZE)                                                                                                       \
+    TEST(RESERVE)                                                                                                      \
+    TEST(SHRINK_TO_FIT)                                                                                                \
+    TEST(ASSIGN)                                                                                                       \
+    TEST(SORT)                                                                                                         \
+    TEST(STABLE_SORT)                                                                                                  \
+    TEST(COPY)                                                                                                         \
+    TEST(SWAP)                                                                                                         \
+    TEST(FIND)                                                                                                         \
+    TEST(REMOVE_IF)
+
+#define GENERATE_ENUM(x) TEST_##x,
+#define GENERATE_NAME(x) #x,
+
+// clang-format off
+enum
+{
+    FOREACH_METH(GENERATE_ENUM)
+    TEST_TOTAL
+};
+static const int number_ok = (int)TEST_TOTAL;
+#ifdef DEBUG
+static const char *test_names[] = {FOREACH_METH(GENERATE_NAME) ""};
+#endif
+// clang-format on
+
+// inline up to N, else on the heap
+#define CHECK(_x, _y)                                                                                                  \
+    {                                                                                                                  \
+        assert(_x.size == _y.size());                                                                                  \
+        assert(svec8_digi_empty(&_x) == _y.empty());                                                                   \
+        assert(_x.capacity >= _x.size && _x.capacity >= 8);                                                            \
+        assert((_x.capacity > 8) == (_x.vector != NULL));                                                              \
+        size_t _i = 0;                                                                                                 \
+        foreach (svec8_digi, &_x, _it)                                                                                 \
+        {                                                                                                              \
+            assert(*_it.ref->value == *_y[_i].value);                                                                  \
+            _i++;                                                                                                      \
+        }                                                                                                              \
+        assert(_i == _y.size());                                                                                       \
+        _i = 0;                                                                                                        \
+        vec_foreach(digi, &_x, _ref)                                                                                   \
+        {                                                                                                              \
+            assert(*_ref->value == *_y[_i].value);                                                                     \
+            _i++;                                                                                                      \
+        }                                                                                                              \
+        assert(_i == _y.size());                                                                                       \
+        for (size_t i = 0; i < _y.size(); i++)                                                                         \
+            assert(*_y.at(i).value == *svec8_digi_at(&_x, i)->value);                                                  \
+    }
+
+int main(void)
+{
+    int fail = 0;
+    INIT_SRAND;
+    INIT_TEST_LOOPS(10,false);
+    for (unsigned loop = 0; loop < loops; loop++)
+    {
+        // mostly around the inline capacity
+        size_t size = TEST_RAND(4) ? TEST_RAND(3 * 8) : TEST_RAND(TEST_MAX_SIZE);
+        svec8_digi a = svec8_digi_init();
+        a.compare = digi_compare;
+        a.equal = digi_equal;
+        std::vector<DIGI> b;
+        for (size_t pushes = 0; pushes < size; pushes++)
+        {
+            const int value = TEST_RAND(TEST_MAX_VALUE);
+            svec8_digi_push_back(&a, digi_init(value));
+            b.push_back(DIGI{value});
+        }
+        const int value = TEST_RAND(TEST_MAX_VALUE);
+        const size_t index = TEST_RAND(a.size);
+        int which;
+        if (tests.size)
+        {
+            which = *queue_int_front(&tests);
+            queue_int_pop(&tests);
+        }
+        else
+            which = (test >= 0 ? test : TEST_RAND(TEST_TOTAL));
+        LOG("TEST %s %d (size %zu, cap %zu)\n", test_names[which], which, a.size, a.capacity);
+        RECORD_WHICH;
+        switch (which)
+        {
+        case TEST_PUSH_BACK: {
+            b.push_back(DIGI{value});
+            svec8_digi_push_back(&a, digi_init(value));
+            break;
+        }
+        case TEST_POP_BACK: {
+            if (a.size > 0)
+            {
+                b.pop_back();
+                svec8_digi_pop_back(&a);
+            }
+            break;
+        }
+        case TEST_CLEAR: {
+            b.clear();
+            svec8_digi_clear(&a);
+            break;
+        }
+        case TEST_ERASE_INDEX: {
+            if (a.size > 0)
+            {
+                b.erase(b.begin() + index);
+                svec8_digi_erase_index(&a, index);
+            }
+            break;
+        }
+        case TEST_ERASE_RANGE: {
+            if (a.size > 0)
+            {
+                const size_t last = index + TEST_RAND(a.size - index);
+                svec8_digi_it range = svec8_digi_begin(&a);
+                svec8_digi_it_advance(&range, index);
+                range.end = &svec8_digi_data(&a)[last];
+                svec8_digi_erase_range(&range);
+                b.erase(b.begin() + index, b.begin() + last);
+            }
+            break;
+        }
+        case TEST_INSERT_INDEX: {
+            b.insert(b.begin() + index, DIGI{value});
+            svec8_digi_insert_index(&a, index, digi_init(value));
+            break;
+        }
+        case TEST_INSERT_COUNT: {
+            const size_t count = TEST_RAND(2 * 8);
+            svec8_digi_it pos = svec8_digi_begin(&a);
+            svec8_digi_it_advance(&pos, index);
+            svec8_digi_insert_count(&pos, count, digi_init(value));
+            b.insert(b.begin() + index, count, DIGI{value});
+            break;
+        }
+        case TEST_INSERT_RANGE_SELF: {
+            // spills while copying from itself
+            svec8_digi_it pos = svec8_digi_begin(&a);
+            svec8_digi_it_advance(&pos, index);
+            svec8_digi_it range = svec8_digi_begin(&a);
+            svec8_digi_insert_range(&pos, &range);
+            std::vector<DIGI> bb = b;
+            b.insert(b.begin() + index, bb.begin(), bb.end());
+            break;
+        }
+        case TEST_RESIZE: {
+            const size_t resize = TEST_RAND(3 * 8);
+            b.resize(resize, DIGI{value});
+            svec8_digi_resize(&a, resize, digi_init(value));
+            break;
+        }
+        case TEST_RESERVE: {
+            const size_t capacity = TEST_RAND(4 * 8);
+            b.reserve(capacity);
+            svec8_digi_reserve(&a, capacity);
+            assert(a.capacity >= capacity);
+            break;
+        }
+        case TEST_SHRINK_TO_FIT: {
+            b.shrink_to_fit();
+            svec8_digi_shrink_to_fit(&a);
+            assert(a.capacity == (a.size > 8 ? a.size : 8));
+            break;
+        }
+        case TEST_ASSIGN: {
+            const size_t count = TEST_RAND(3 * 8);
+            b.assign(count, DIGI{value});
+            svec8_digi_assign(&a, count, digi_init(value));
+            break;
+        }
+        case TEST_SORT: {
+            svec8_digi_sort(&a);
+            std::sort(b.begin(), b.end());
+            break;
+        }
+        case TEST_STABLE_SORT: {
+            a.compare = digi_compare_low;
+            svec8_digi_stable_sort(&a);
+            std::stable_sort(b.begin(), b.end(), [](const DIGI &x, const DIGI &y) {
+                return (*x.value & 15) < (*y.value & 15);
+            });
+            a.compare = digi_compare;
+            break;
+        }
+        case TEST_COPY: {
+            svec8_digi aa = svec8_digi_copy(&a);
+            std::vector<DIGI> bb = b;
+            CHECK(aa, bb);
+            svec8_digi_free(&aa);
+            break;
+        }
+        case TEST_SWAP: {
+            svec8_digi aa = svec8_digi_copy(&a);
+            svec8_digi aaa = svec8_digi_init();
+            std::vector<DIGI> bb = b;
+            std::vector<DIGI> bbb;
+            svec8_digi_swap(&aaa, &aa);
+            std::swap(bb, bbb);
+            CHECK(aaa, bbb);
+            svec8_digi_free(&aaa);
+            svec8_digi_free(&aa);
+            break;
+        }
+        case TEST_FIND: {
+            if (a.size > 0 && TEST_RAND(2))
+            {
+                *svec8_digi_at(&a, index)->value = value;
+                *b[index].value = value;
+            }
+            digi key = digi_init(value);
+            svec8_digi_it found_a = svec8_digi_find(&a, key);
+            auto found_b = std::find(b.begin(), b.end(), DIGI{value});
+            assert(svec8_digi_it_done(&found_a) == (found_b == b.end()));
+            if (found_b != b.end())
+                assert(svec8_digi_it_index(&found_a) == (size_t)(found_b - b.begin()));
+            digi_free(&key);
+            break;
+        }
+        case TEST_REMOVE_IF: {
+            b.erase(std::remove_if(b.begin(), b.end(), DIGIc_is_odd), b.end());
+            svec8_digi_remove_if(&a, digi_is_odd);
+            break;
+        }
+        }
+        CHECK(a, b);
+        svec8_digi_free(&a);
+    }
+    svec4_ldbl d = svec4_ldbl_init();
+    for (int n = 1; n <= 8; n++)
+    {
+        svec4_ldbl_push_back(&d, (ldbl)n);
+        int i = 0;
+        vec_foreach(ldbl, &d, ref)
+            assert(*ref == (ldbl)++i);
+        assert(i == n);
+    }
+    svec4_ldbl_free(&d);
+    FINISH_TEST(__FILE__);
+}
+
+#endif // C++11
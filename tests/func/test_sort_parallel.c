@@ -0,0 +1,120 @@
+// Test the parallel sample sort of vectors, deques and arrays against qsort.
+#define CTL_SORT_PARALLEL
+#include "../test.h"
+
+typedef struct
+{
+    int key;
+    int pos;
+} point;
+
+static int point_compare(point *a, point *b)
+{
+    return a->key < b->key;
+}
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#define POD
+#define NOT_INTEGRAL
+#define T point
+#include <ctl/vector.h>
+
+#define POD
+#define T int
+#include <ctl/deque.h>
+
+#define POD
+#define T long
+#define N 100000
+#include <ctl/array.h>
+
+#define SIZE 100000
+
+static int int_cmp(const void *a, const void *b)
+{
+    return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+static int long_cmp(const void *a, const void *b)
+{
+    return (*(const long *)a > *(const long *)b) - (*(const long *)a < *(const long *)b);
+}
+
+static int expected[SIZE];
+static arr100000_long a;
+static long along[SIZE];
+
+static void fill(int mode)
+{
+    for (int i = 0; i < SIZE; i++)
+        switch (mode)
+        {
+        case 0:
+            expected[i] = rand() - RAND_MAX / 2;
+            break;
+        case 1: // many duplicates
+            expected[i] = rand() % 10;
+            break;
+        case 2: // all equal, one bucket
+            expected[i] = 7;
+            break;
+        default: // descending
+            expected[i] = SIZE - i;
+        }
+}
+
+int main(void)
+{
+    INIT_SRAND;
+    static const size_t threads[] = {0, 1, 2, 3, 7, 300};
+    a = arr100000_long_init();
+    for (int mode = 0; mode < 4; mode++)
+        for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+        {
+            fill(mode);
+            vec_int v = vec_int_init();
+            vec_point p = vec_point_init();
+            p.compare = point_compare;
+            deq_int d = deq_int_init();
+            for (int i = 0; i < SIZE; i++)
+            {
+                point pt = {expected[i], i};
+                vec_int_push_back(&v, expected[i]);
+                vec_point_push_back(&p, pt);
+                deq_int_push_back(&d, expected[i]);
+                a.vector[i] = along[i] = (long)expected[i] * 3;
+            }
+            vec_int_sort_parallel(&v, threads[t]);
+            vec_point_sort_parallel(&p, threads[t]);
+            deq_int_sort_parallel(&d, threads[t]);
+            arr100000_long_sort_parallel(&a, threads[t]);
+            qsort(expected, SIZE, sizeof(int), int_cmp);
+            qsort(along, SIZE, sizeof(long), long_cmp);
+            assert(!memcmp(v.vector, expected, sizeof(expected)));
+            assert(!memcmp(a.vector, along, sizeof(along)));
+            // no element lost or doubled
+            long long sum = 0;
+            for (int i = 0; i < SIZE; i++)
+            {
+                assert(p.vector[i].key == expected[i]);
+                assert(*deq_int_at(&d, i) == expected[i]);
+                sum += p.vector[i].pos;
+            }
+            assert(sum == (long long)SIZE * (SIZE - 1) / 2);
+            vec_int_free(&v);
+            vec_point_free(&p);
+            deq_int_free(&d);
+        }
+    // below CTL_SORT_PARALLEL_MIN, serial
+    vec_int s = vec_int_init();
+    for (int i = 0; i < 1000; i++)
+        vec_int_push_back(&s, rand());
+    vec_int_sort_parallel(&s, 4);
+    for (int i = 1; i < 1000; i++)
+        assert(s.vector[i - 1] <= s.vector[i]);
+    vec_int_free(&s);
+    TEST_PASS(__FILE__);
+}
@@ -20,6 +20,7 @@ OLD_MAIN
     TEST(PUSH_BACK)                                                                                                    \
     TEST(POP_BACK)                                                                                                     \
     TEST(APPEND)                                                                                                       \
+    TEST(INSERT_STR)                                                                                                   \
     TEST(C_STR)                                                                                                        \
     TEST(CLEAR)                                                                                                        \
     TEST(ERASE)                                                                                                        \
@@ -41,6 +42,8 @@ OLD_MAIN
     TEST(REPLACE)                                                                                                      \
     TEST(FIND)                                                                                                         \
     TEST(RFIND)                                                                                                        \
+    TEST(FIND_N)                                                                                                       \
+    TEST(SEARCHER)                                                                                                     \
     TEST(FIND_FIRST_OF)                                                                                                \
     TEST(FIND_FIRST_OF_RANGE)                                                                                          \
     TEST(FIND_LAST_OF)                                                                                                 \
@@ -175,6 +178,7 @@ static const char *test_names[] = {
         assert(strlen(str_c_str(&_x)) == strlen(_y.c_str()));                                                          \
         assert(strcmp(str_c_str(&_x), _y.c_str()) == 0);                                                               \
         ASSERT_EQUAL_CAP(_x, _y);                                                                                      \
+        assert((_x.capacity > CTL_STR_SSO) == (_x.vector != NULL)); /* inline else */                                  \
         assert(_x.size == _y.size());                                                                                  \
         assert(str_empty(&_x) == _y.empty());                                                                          \
         if (_x.size > 0)                                                                                               \
@@ -199,7 +203,7 @@ static const char *test_names[] = {
     }
 
 #define CHECK_ITER(aa, b, bb)                                                                                          \
-    if ((aa).ref != &(aa).container->vector[(aa).container->size])                                                     \
+    if ((aa).ref != &str_c_str((aa).container)[(aa).container->size])                                                     \
     {                                                                                                                  \
         assert(bb != b.end());                                                                                         \
         assert(*(aa).ref == *bb);                                                                                      \
@@ -229,6 +233,19 @@ static char *create_test_string(size_t size)
     return temp;
 }
 
+// some bytes over 0x80, in a and b and one in the set
+static void set_high_bytes(str *a, std::string &b, char *set)
+{
+    for (size_t i = 0; i < a->size; i += 1 + TEST_RAND(8))
+    {
+        const char c = (char)(0x80 + TEST_RAND(4));
+        *str_at(a, i) = c;
+        b[i] = c;
+    }
+    if (*set)
+        set[0] = (char)(0x80 + TEST_RAND(4));
+}
+
 static int char_compare(char *a, char *b)
 {
     return *a < *b;
@@ -416,6 +433,12 @@ int main(void)
                 b.append(temp);
                 free(temp);
                 break;
+            case TEST_INSERT_STR:
+                temp = create_test_string(TEST_RAND(256));
+                str_insert_str(&a, index, temp);
+                b.insert(index, temp);
+                free(temp);
+                break;
             case TEST_C_STR:
                 assert(strlen(str_c_str(&a))); // strlen(NULL) is valid
                 assert(str_c_str(&a) == str_data(&a));
@@ -441,10 +464,44 @@ int main(void)
                 free(temp);
                 break;
             }
+            case TEST_FIND_N: {
+                // also after an embedded \0
+                if (a.size > 1 && TEST_RAND(2))
+                {
+                    *str_at(&a, index / 2) = '\0';
+                    b[index / 2] = '\0';
+                }
+                const size_t size = TEST_RAND(4);
+                temp = create_test_string(size);
+                const size_t n = TEST_RAND(size + 1);
+                if (n && TEST_RAND(2))
+                    temp[0] = '\0';
+                assert(str_find_n(&a, temp, n) == b.find(temp, 0, n));
+                free(temp);
+                break;
+            }
+            case TEST_SEARCHER: {
+                // all matches of a part of a, short and long
+                const size_t size = TEST_RAND(TEST_RAND(2) ? 4 : 2 * CTL_STR_SEARCHER_MIN) + 1;
+                std::string needle = b.substr(index, size);
+                str_searcher searcher = str_searcher_init(needle.c_str());
+                size_t from_a = 0, from_b = 0;
+                do
+                {
+                    from_a = str_searcher_find(&searcher, &a, from_a);
+                    from_b = b.find(needle, from_b);
+                    assert(from_a == from_b);
+                    from_a++;
+                    from_b++;
+                } while (from_b != 0);
+                break;
+            }
             case TEST_FIND_FIRST_OF: {
                 const size_t size = TEST_RAND(4);
                 temp = create_test_string(size);
-                LOG("str_find_first_of(\"%s\", \"%s\')\n", a.vector, temp);
+                if (TEST_RAND(2))
+                    set_high_bytes(&a, b, temp);
+                LOG("str_find_first_of(\"%s\", \"%s\')\n", str_c_str(&a), temp);
                 num_a = str_find_first_of(&a, temp);
                 num_b = b.find_first_of(temp);
                 LOG("=> %zu vs %zu\n", num_a, num_b);
@@ -465,7 +522,7 @@ int main(void)
                 found_a = str_find_first_of_range(&range_a1, &range_a2);
                 iter = std::find_first_of(first_b1, last_b1, bb.begin(), bb.end());
                 LOG("=> %s/%s, %ld/%ld\n", found_a ? "yes" : "no", iter != last_b1 ? "yes" : "no",
-                    range_a1.ref - a.vector, iter - first_b1);
+                    range_a1.ref - str_c_str(&a), iter - first_b1);
                 if (found_a)
                     assert(*iter == *range_a1.ref);
                 else
@@ -476,6 +533,8 @@ int main(void)
             case TEST_FIND_LAST_OF: {
                 const size_t size = TEST_RAND(3);
                 temp = create_test_string(size);
+                if (TEST_RAND(2))
+                    set_high_bytes(&a, b, temp);
                 assert(str_find_last_of(&a, temp) == b.find_last_of(temp));
                 free(temp);
                 break;
@@ -483,6 +542,8 @@ int main(void)
             case TEST_FIND_FIRST_NOT_OF: {
                 const size_t size = TEST_RAND(192);
                 temp = create_test_string(size);
+                if (TEST_RAND(2))
+                    set_high_bytes(&a, b, temp);
                 assert(str_find_first_not_of(&a, temp) == b.find_first_not_of(temp));
                 free(temp);
                 break;
@@ -490,6 +551,8 @@ int main(void)
             case TEST_FIND_LAST_NOT_OF: {
                 const size_t size = TEST_RAND(192);
                 temp = create_test_string(size);
+                if (TEST_RAND(2))
+                    set_high_bytes(&a, b, temp);
                 assert(str_find_last_not_of(&a, temp) == b.find_last_not_of(temp));
                 free(temp);
                 break;
@@ -506,7 +569,7 @@ int main(void)
                 break;
             }
             case TEST_COMPARE: {
-                char *ta = a.vector;
+                char *ta = str_c_str(&a);
                 char *tb = create_test_string(index);
                 aa = str_init(tb);
                 b = ta;
@@ -640,7 +703,7 @@ int main(void)
                 bb = b;
                 if (TEST_RAND(2) && a.size)
                 {
-                    a.vector[0] = 'a';
+                    str_c_str(&a)[0] = 'a';
                     b[0] = 'a';
                 }
                 bool same_b = b == bb;
@@ -654,7 +717,7 @@ int main(void)
                 b.resize(size1);
                 get_random_iters(&a, &range_a1, b, first_b1, last_b1);
                 index = TEST_RAND(a.size - 1);
-                value = a.size ? a.vector[index] : 'a';
+                value = a.size ? str_c_str(&a)[index] : 'a';
                 LOG("equal_value %c of \"%.*s\"\n", value, (int)(range_a1.end - range_a1.ref), range_a1.ref);
                 bool same_a = str_equal_value(&range_a1, value);
                 bool same_b = first_b1 != last_b1;
@@ -722,7 +785,7 @@ int main(void)
                 str_generate(&a, str_generate);
                 str_generate_reset();
                 std::generate(b.begin(), b.end(), STR_generate);
-                LOG("\"%s\" (%zu) vs \"%s\" (%zu)\n", a.vector, a.size, b.c_str(), b.size());
+                LOG("\"%s\" (%zu) vs \"%s\" (%zu)\n", str_c_str(&a), a.size, b.c_str(), b.size());
                 CHECK(a, b);
                 break;
             }
@@ -732,12 +795,12 @@ int main(void)
                 str_generate_reset();
                 str_generate_n(&a, count, str_generate);
                 size_t min = MIN(count, a.size);
-                a.vector[min] = '\0';
+                str_c_str(&a)[min] = '\0';
                 str_generate_reset();
                 std::generate_n(b.begin(), count, STR_generate);
                 b[min] = '\0';
                 LOG("count %zu: \"%s\" (%zu) vs \"%s\" (%zu)\n",
-                    count, a.vector, a.size, b.c_str(), b.size());
+                    count, str_c_str(&a), a.size, b.c_str(), b.size());
                 CHECK(a, b);
                 break;
             }
@@ -760,7 +823,7 @@ int main(void)
                 iter = find_end(b.begin(), b.end(), bb.begin(), bb.end());
                 found_a = !str_it_done(&it);
                 found_b = iter != b.end();
-                LOG("=> %s/%s, %ld/%ld\n", found_a ? "yes" : "no", found_b ? "yes" : "no", it.ref - a.vector,
+                LOG("=> %s/%s, %ld/%ld\n", found_a ? "yes" : "no", found_b ? "yes" : "no", it.ref - str_c_str(&a),
                     iter - b.begin());
                 CHECK_ITER(it, b, iter);
                 assert(found_a == found_b);
@@ -1162,7 +1225,7 @@ int main(void)
                 if (a.size < 2)
                     break;
                 get_random_iters(&a, &range_a1, b, first_b1, last_b1);
-                aa = str_init(a.vector);
+                aa = str_init(str_c_str(&a));
                 it = str_it_begin(&aa);
                 /*str_it it = */
                 str_transform_range(&range_a1, it, str_untrans);
@@ -1266,7 +1329,7 @@ int main(void)
                     str_set(&aa, i, ' ');
                     bb[i] = ' ';
                 }
-                LOG("search \"%s\" in \"%s\" (%zu)\n", range_a1.ref, a.vector, a.size);
+                LOG("search \"%s\" in \"%s\" (%zu)\n", range_a1.ref, str_c_str(&a), a.size);
                 // print_str_range(range_a1);
                 it = str_search(&a, &range_a1);
                 iter = search(b.begin(), b.end(), first_b1, last_b1);
@@ -1285,7 +1348,7 @@ int main(void)
                     str_set(&aa, i, ' ');
                     bb[i] = ' ';
                 }
-                LOG("search \"%s\" in \"%s\" (%zu)\n", range_a2.ref, a.vector, a.size);
+                LOG("search \"%s\" in \"%s\" (%zu)\n", range_a2.ref, str_c_str(&a), a.size);
                 // print_str_range(needle);
                 it = str_it_begin(&a);
                 found_a = str_search_range(&it, &range_a2);
@@ -1348,7 +1411,7 @@ int main(void)
                 found_b = iter != b.end();
                 long dist = std::distance(b.begin(), iter);
                 b.resize(dist);
-                LOG("found %s at %zu of \"%s\" ", found_a ? "yes" : "no", index, a.vector);
+                LOG("found %s at %zu of \"%s\" ", found_a ? "yes" : "no", index, str_c_str(&a));
                 LOG("vs found %s at %ld of \"%s\"\n", found_b ? "yes" : "no", dist, b.c_str());
                 // print_string(b);
                 assert(found_a == found_b);
@@ -1357,7 +1420,7 @@ int main(void)
             }
             case TEST_UNIQUE_RANGE: {
                 get_random_iters(&a, &range_a1, b, first_b1, last_b1);
-                LOG("\"%.*s\" of \"%s\"\n", (int)(range_a1.end - range_a1.ref), range_a1.ref, a.vector);
+                LOG("\"%.*s\" of \"%s\"\n", (int)(range_a1.end - range_a1.ref), range_a1.ref, str_c_str(&a));
                 it = str_unique_range(&range_a1);
                 found_a = !str_it_done(&it);
                 index = str_it_index(&it);
@@ -1450,7 +1513,7 @@ int main(void)
                 aaa = str_merge(&a, &aa);
 # ifndef _MSC_VER
                 std::merge(b.begin(), b.end(), bb.begin(), bb.end(), std::back_inserter(bbb));
-                LOG("merge \"%s\", \"%s\" => \"%s\" (%zu)\n", a.vector, aa.vector, aaa.vector, aaa.size);
+                LOG("merge \"%s\", \"%s\" => \"%s\" (%zu)\n", str_c_str(&a), str_c_str(&aa), str_c_str(&aaa), aaa.size);
                 LOG("vs    \"%s\", \"%s\" => \"%s\" (%zu)\n", b.c_str(), bb.c_str(), bbb.c_str(), bbb.size());
                 ADJUST_CAP("merge", aaa, bbb);
                 CHECK(aaa, bbb);
@@ -1471,7 +1534,7 @@ int main(void)
 #ifndef _MSC_VER
                 std::merge(first_b1, last_b1, first_b2, last_b2, std::back_inserter(bbb));
                 LOG("merge_range \"%.*s\", \"%.*s\" => \"%s\" (%zu)\n", (int)(range_a1.end - range_a1.ref),
-                    range_a1.ref, (int)(range_a2.end - range_a2.ref), range_a2.ref, aaa.vector, aaa.size);
+                    range_a1.ref, (int)(range_a2.end - range_a2.ref), range_a2.ref, str_c_str(&aaa), aaa.size);
                 LOG("vs          \"%.*s\", \"%.*s\" => \"%s\" (%zu)\n", (int)(last_b1 - first_b1), &(*first_b1),
                     (int)(last_b2 - first_b2), &(*first_b2), bbb.c_str(), bbb.size());
                 ADJUST_CAP("merge_range", aaa, bbb);
@@ -1488,7 +1551,7 @@ int main(void)
                 std::sort(bb.begin(), bb.end());
                 found_a = str_includes(&a, &aa);
                 found_b = std::includes(b.begin(), b.end(), bb.begin(), bb.end());
-                LOG("includes \"%.*s\", \"%.*s\" => %d\n", (int)a.size, a.vector, (int)aa.size, aa.vector, (int)found_a);
+                LOG("includes \"%.*s\", \"%.*s\" => %d\n", (int)a.size, str_c_str(&a), (int)aa.size, str_c_str(&aa), (int)found_a);
                 LOG("vs       \"%.*s\", \"%.*s\" => %d\n", (int)b.size(), b.c_str(), (int)bb.size(), bb.c_str(),
                     (int)found_b);
                 assert(found_a == found_b);
@@ -1535,18 +1598,18 @@ int main(void)
                 CHECK_RANGE(*pos, first_b1, last_b1);
                 break;
             case TEST_REVERSE:
-                LOG("%s\n", a.vector);
+                LOG("%s\n", str_c_str(&a));
                 str_reverse(&a);
                 std::reverse(b.begin(), b.end());
-                LOG("%s\n", a.vector);
+                LOG("%s\n", str_c_str(&a));
                 CHECK(a, b);
                 break;
             case TEST_REVERSE_RANGE:
                 get_random_iters(&a, &range_a1, b, first_b1, last_b1);
-                LOG("%s\n", a.vector);
+                LOG("%s\n", str_c_str(&a));
                 str_reverse_range(&range_a1);
                 std::reverse(first_b1, last_b1);
-                LOG("%s\n", a.vector);
+                LOG("%s\n", str_c_str(&a));
                 CHECK(a, b);
                 break;
 
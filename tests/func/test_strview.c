@@ -0,0 +1,97 @@
+// Test strview, and the lookups of views in a set and uset of str without an
+// allocation.
+#include "../test.h"
+
+static long allocs;
+
+static void *count_alloc(size_t size)
+{
+    allocs++;
+    return malloc(size);
+}
+
+#define CTL_ALLOC(size) count_alloc(size)
+#define CTL_REALLOC(ptr, size) realloc(ptr, size)
+#define CTL_FREE(ptr) free(ptr)
+#include <ctl/string.h>
+
+#define T str
+#include <ctl/set.h>
+
+#define T str
+#include <ctl/unordered_set.h>
+
+#define WORDS 200
+
+int main(void)
+{
+    INIT_SRAND;
+    // words of 1 to 40 characters in one buffer, each without \0
+    char buf[WORDS * 41];
+    strview words[WORDS];
+    size_t size = 0;
+    for (int i = 0; i < WORDS; i++)
+    {
+        const size_t len = 1 + TEST_RAND(TEST_RAND(2) ? 4 : 40);
+        words[i] = strview_init_n(&buf[size], len);
+        for (size_t j = 0; j < len; j++)
+            buf[size++] = 'a' + TEST_RAND(3);
+        buf[size++] = ' ';
+    }
+    strview all = strview_init_n(buf, size);
+
+    set_str t = set_str_init(str_key_compare);
+    uset_str u = uset_str_init(str_hash, str_equal);
+    for (int i = 0; i < WORDS; i += 2)
+    {
+        set_str_insert(&t, strview_str(words[i]));
+        uset_str_insert(&u, strview_str(words[i]));
+    }
+    allocs = 0;
+    for (int i = 0; i < WORDS; i++)
+    {
+        strview w = words[i];
+        bool inserted = false;
+        for (int j = 0; j < WORDS; j += 2)
+            inserted |= strview_equal(w, words[j]);
+        assert((set_str_find_node(&t, strview_key(w)) != NULL) == inserted);
+        assert((uset_str_find_node(&u, strview_key(w)) != NULL) == inserted);
+
+        // the word is found in all, no later than its place
+        const size_t at = (size_t)(w.data - buf);
+        assert(strview_find(all, w) <= at);
+        assert(strview_rfind(all, w) >= at && strview_rfind(all, w) != SIZE_MAX);
+        assert(strview_starts_with(strview_substr(all, at, size - at), w));
+        assert(strview_ends_with(strview_substr(all, 0, at + w.size), w));
+        assert(strview_compare(w, strview_substr(w, 0, w.size - 1)) > 0);
+        assert(strview_compare(strview_substr(w, 0, w.size - 1), w) < 0);
+        assert(strview_compare(w, w) == 0);
+    }
+    assert(allocs == 0);
+
+    // with the hash and order of str
+    for (int i = 0; i < WORDS; i++)
+    {
+        str a = strview_str(words[i]);
+        str b = strview_str(words[(i + 1) % WORDS]);
+        assert(a.size == words[i].size && str_c_str(&a)[a.size] == '\0');
+        assert(strview_hash(words[i]) == str_hash(&a));
+        strview view = str_view(&a);
+        assert(strview_equal(view, words[i]));
+        assert(strview_equal(str_substr_view(&a, 1, a.size - 1), strview_substr(words[i], 1, a.size - 1)));
+        const int cmp = str_key_compare(&a, &b);
+        const int vcmp = strview_compare(words[i], words[(i + 1) % WORDS]);
+        assert((cmp < 0) == (vcmp < 0) && (cmp > 0) == (vcmp > 0));
+        str_free(&a);
+        str_free(&b);
+    }
+    strview empty = strview_init("");
+    assert(strview_find(all, empty) == 0);
+    assert(strview_starts_with(all, empty));
+    assert(!strview_starts_with(empty, all));
+    assert(strview_find(empty, all) == SIZE_MAX);
+
+    set_str_free(&t);
+    uset_str_free(&u);
+    TEST_PASS(__FILE__);
+}
@@ -49,7 +49,8 @@ OLD_MAIN
     TEST(EMPLACE_FOUND)                                                                                                \
     TEST(EMPLACE_HINT) /* 30 */                                                                                        \
     TEST(MERGE)                                                                                                        \
-    TEST(MERGE_RANGE)
+    TEST(MERGE_RANGE)                                                                                                  \
+    TEST(FIND_BATCH)
 
 #define FOREACH_DEBUG(TEST)                                                                                            \
     TEST(EXTRACT) /* 33 */                                                                                             \
@@ -80,9 +81,19 @@ static const char *test_names[] = {
 #endif
 // clang-format on
 
+#ifdef CTL_USET_BUCKET_BITMAP
+// a bit for each and only the non-empty buckets
+#define CHECK_BITMAP(_x)                                                                                               \
+    for (size_t _i = 0; _x.buckets && _i <= _x.bucket_max; _i++)                                                       \
+        assert(!!(_x.used[_i / 64] & (UINT64_C(1) << (_i % 64))) == !!_x.buckets[_i])
+#else
+#define CHECK_BITMAP(_x)
+#endif
+
 #define CHECK(_x, _y)                                                                                                  \
     {                                                                                                                  \
         assert(_x.size == _y.size());                                                                                  \
+        CHECK_BITMAP(_x);                                                                                              \
         if (_x.size > 0)                                                                                               \
         {                                                                                                              \
             size_t a_found = 0;                                                                                        \
@@ -358,6 +369,28 @@ int main(void)
             uset_digi_clear(&a);
             break;
         }
+        case TEST_FIND_BATCH: {
+            digi keys[40];
+            digi *refs[40];
+            bool has[40];
+            const size_t n = TEST_RAND(40);
+            for (size_t i = 0; i < n; i++)
+                keys[i] = digi_init(TEST_RAND(TEST_MAX_VALUE));
+            uset_digi_find_batch(&a, keys, n, refs);
+            for (size_t i = 0; i < n; i++)
+            {
+                iter = b.find(DIGI{*keys[i].value});
+                if (iter == b.end())
+                    assert(!refs[i]);
+                else
+                    assert(refs[i] && *iter->value == *refs[i]->value);
+            }
+            // contains_batch consumes the keys
+            uset_digi_contains_batch(&a, keys, n, has);
+            for (size_t i = 0; i < n; i++)
+                assert(has[i] == (refs[i] != NULL));
+            break;
+        }
         case TEST_COPY: { // C++20
             aa = uset_digi_copy(&a);
             bb = b;
@@ -711,6 +744,14 @@ int main(void)
     FINISH_TEST("tests/func/test_unordered_set_power2");
 #elif defined CTL_USET_CACHED_HASH
     FINISH_TEST("tests/func/test_unordered_set_cached");
+#elif defined CTL_USET_NODE_POOL
+    FINISH_TEST("tests/func/test_unordered_set_pool");
+#elif defined CTL_USET_INCREMENTAL_REHASH
+    FINISH_TEST("tests/func/test_unordered_set_incremental");
+#elif defined CTL_USET_SEEDED
+    FINISH_TEST("tests/func/test_unordered_set_seeded");
+#elif defined CTL_USET_BUCKET_BITMAP
+    FINISH_TEST("tests/func/test_unordered_set_bitmap");
 #else
     FINISH_TEST(__FILE__);
 #endif
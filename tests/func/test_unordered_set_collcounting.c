@@ -0,0 +1,100 @@
+// Test that long chains from DDOS attacks are indexed, and not slept on.
+#include "../test.h"
+
+// built with 1 and 4 (sorted vector), and 5 (tree)
+#ifndef CTL_USET_SECURITY_COLLCOUNTING
+#define CTL_USET_SECURITY_COLLCOUNTING 4
+#endif
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#ifndef _WIN32
+inline unsigned int sleep(unsigned int seconds)
+{
+    (void)seconds;
+    assert(!"no sleep with CTL_USET_SECURITY_COLLCOUNTING 1, 4 or 5");
+    return 0;
+}
+#endif
+
+static inline size_t
+broken_hash(int* a)
+{
+    (void)a;
+    return 0;
+}
+
+static int is_odd(int *a)
+{
+    return *a % 2;
+}
+
+int main(void)
+{
+    srand(0xbebe);
+    const int size = 1000;
+    uset_int a = uset_int_init(broken_hash, NULL);
+    uset_int_rehash(&a, size);
+    for (int i = 0; i < size; i++)
+    {
+        const int vb = TEST_RAND(1000);
+        uset_int_insert(&a, vb);
+    }
+    // all in bucket 0, which is now indexed
+#if CTL_USET_SECURITY_COLLCOUNTING == 5
+    assert(a.trees && a.trees[0]);
+    assert(a.trees[0]->size == a.size);
+#else
+    assert(a.sorted && a.sorted[0].nodes);
+    assert(a.sorted[0].size == a.size);
+#endif
+    size_t n = 0;
+    foreach(uset_int, &a, it)
+    {
+        assert(uset_int_contains(&a, *it.ref));
+        n++;
+    }
+    assert(n == a.size);
+    {
+        int keys[50];
+        bool has[50];
+        for (int i = 0; i < 50; i++)
+            keys[i] = i;
+        uset_int_contains_batch(&a, keys, 50, has);
+        for (int i = 0; i < 50; i++)
+            assert(has[i] == uset_int_contains(&a, i));
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        const int vb = TEST_RAND(1000);
+        uset_int_erase(&a, vb);
+        assert(!uset_int_contains(&a, vb));
+        uset_int_it it = uset_int_find(&a, vb);
+        it = uset_int_emplace_hint(&it, (int*)&vb);
+        assert(uset_int_contains(&a, vb));
+    }
+    // the keys left, by a linear walk not using the index
+    bool present[1000] = {false};
+    foreach(uset_int, &a, it)
+        present[*it.ref] = true;
+    uset_int_erase_if(&a, is_odd);
+    foreach(uset_int, &a, it)
+        assert(!is_odd(it.ref));
+    for (int i = 0; i < size; i++)
+    {
+        const bool expect = present[i] && !(i % 2);
+        assert(uset_int_count(&a, i) == (size_t)expect);
+        assert(uset_int_contains(&a, i) == expect);
+    }
+    uset_int b = uset_int_copy(&a);
+    assert(uset_int_equal(&a, &b));
+    uset_int_free(&b);
+    // grows, and drops the index
+    for (int i = 0; i < 10 * size; i++)
+        uset_int_insert(&a, i);
+    assert(a.size == (size_t)10 * size);
+    for (int i = 0; i < 10 * size; i++)
+        assert(uset_int_contains(&a, i));
+    uset_int_free(&a);
+}
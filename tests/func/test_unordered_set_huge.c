@@ -0,0 +1,57 @@
+// Test the 64-bit bucket indexing.
+// Without args only the sizing functions are checked. With an element count
+// (e.g. 5000000000, needs ~150GB RAM) a table past 2^32 elements is filled
+// and probed.
+#define CTL_MAX_SIZE (UINT64_C(1) << 48)
+#include "../test.h"
+
+#define POD
+#define T long
+#include <ctl/unordered_set.h>
+
+#include <stdio.h>
+
+int main(int argc, char **argv)
+{
+#if SIZE_MAX > UINT32_MAX
+    const size_t big = (size_t)1 << 33;
+    // the primes continue past 2^32
+    size_t p = uset_long___next_prime(big);
+    assert(p > big);
+    assert(p % 2 && p % 3 && p % 5 && p % 7);
+    assert(uset_long___next_prime(p) == p);
+    assert(uset_long___next_prime(5000000000UL) > 5000000000UL);
+#ifdef CTL_USET_GROWTH_POWER2
+    assert(uset_long___next_power2(big) == big);
+    assert(uset_long___next_power2(big + 1) == big << 1);
+#endif
+    // the index reaches the upper buckets
+    size_t max = 0;
+    for (long i = 0; i < 1000; i++)
+    {
+        size_t index = uset_long__reduce(ctl_hash_int(i), big - 1);
+        assert(index < big);
+        if (index > max)
+            max = index;
+    }
+    assert(max > UINT32_MAX);
+    assert(ctl_fastrange(SIZE_MAX, big) == big - 1);
+    assert(ctl_fastrange(0, big) == 0);
+    assert(uset_long_max_size() == (UINT64_C(1) << 48) / sizeof(long));
+#endif
+    if (argc > 1)
+    {
+        const size_t n = strtoull(argv[1], NULL, 10);
+        uset_long a = uset_long_init(NULL, NULL);
+        uset_long_reserve(&a, n);
+        for (size_t i = 0; i < n; i++)
+            uset_long_insert(&a, (long)i);
+        assert(a.size == n);
+        printf("%zu elements in %zu buckets\n", a.size, uset_long_bucket_count(&a));
+        for (size_t i = 0; i < n; i += 1 + n / 1000000)
+            assert(uset_long_contains(&a, (long)i));
+        assert(!uset_long_contains(&a, (long)n));
+        uset_long_free(&a);
+    }
+    TEST_PASS(__FILE__);
+}
@@ -29,10 +29,13 @@ OLD_MAIN
     TEST(INSERT_INDEX)                                                                                                 \
     TEST(INSERT_COUNT)                                                                                                 \
     TEST(INSERT_RANGE)                                                                                                 \
+    TEST(INSERT_RANGE_SELF)                                                                                            \
     TEST(RESIZE)                                                                                                       \
     TEST(RESERVE)                                                                                                      \
     TEST(SHRINK_TO_FIT)                                                                                                \
     TEST(SORT)                                                                                                         \
+    TEST(STABLE_SORT)                                                                                                  \
+    TEST(STABLE_SORT_RANGE)                                                                                            \
     TEST(COPY)                                                                                                         \
     TEST(SWAP)                                                                                                         \
     TEST(ASSIGN)                                                                                                       \
@@ -565,6 +568,23 @@ int main(void)
                 }
                 break;
             }
+            case TEST_INSERT_RANGE_SELF: {
+                if (a.size > 2)
+                {
+                    // from the vector itself, before, across or after index
+                    get_random_iters(&a, &range_a2, b, first_b2, last_b2);
+                    std::vector<DIGI> copy(first_b2, last_b2);
+                    it = vec_digi_begin(&a);
+                    vec_digi_it_advance(&it, index);
+                    b.insert(b.begin() + index, copy.begin(), copy.end());
+                    vec_digi_insert_range(&it, &range_a2);
+                    ADJUST_CAP("insert", a, b);
+                    print_vec(&a);
+                    print_vector(b);
+                    CHECK(a, b);
+                }
+                break;
+            }
             case TEST_ASSIGN_RANGE: {
                 print_vec(&a);
                 aa = vec_digi_init_from(&a);
@@ -642,6 +662,23 @@ int main(void)
                 std::sort(b.begin(), b.end());
                 break;
             }
+            case TEST_STABLE_SORT: {
+                a.compare = digi_compare_low;
+                vec_digi_stable_sort(&a);
+                a.compare = digi_compare;
+                std::stable_sort(b.begin(), b.end(), DIGI_compare_low);
+                CHECK(a, b);
+                break;
+            }
+            case TEST_STABLE_SORT_RANGE: {
+                get_random_iters(&a, &range_a1, b, first_b1, last_b1);
+                a.compare = digi_compare_low;
+                vec_digi_stable_sort_range(&range_a1);
+                a.compare = digi_compare;
+                std::stable_sort(first_b1, last_b1, DIGI_compare_low);
+                CHECK(a, b);
+                break;
+            }
             case TEST_COPY: {
                 aa = vec_digi_copy(&a);
                 bb = b;
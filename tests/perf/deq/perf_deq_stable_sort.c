@@ -0,0 +1,26 @@
+// Stable sort of partially sorted ints: ascending, with every 16th random.
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/deque.h>
+
+#include <time.h>
+
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        deq_int c = deq_int_init();
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            deq_int_push_back(&c, elem % 16 ? elem : rand() % (elems + 1));
+        long t0 = TEST_TIME();
+        deq_int_stable_sort(&c);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        deq_int_free(&c);
+    }
+}
@@ -45,7 +45,7 @@ def plot_from_data(name_plot_hash, title):
    used_basenames = []
    trace_list = []
    for idx, name in enumerate(name_plot_hash.keys()):
-       trace_color = color_list[int(idx / 2)]
+       trace_color = color_list[int(idx / 2) % len(color_list)]
        trace = go.Scatter(
            x=name_plot_hash[name]["num_of_ints"],
            y=name_plot_hash[name]["time"],
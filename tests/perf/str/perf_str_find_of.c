@@ -0,0 +1,31 @@
+#include "../../test.h"
+
+#include <ctl/string.h>
+
+#include <time.h>
+
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        str c = str_init("");
+        int elems = TEST_PERF_CHUNKS * run;
+        // words of a log line, without the separators
+        for(int elem = 0; elem < elems; elem++)
+            str_push_back(&c, TEST_RAND(8) ? 'a'+TEST_RAND(23) : ' ');
+        long t0 = TEST_TIME();
+        volatile size_t sum = 0;
+        for(int loop = 0; loop < 25; loop++)
+        {
+            sum = sum + str_find_first_of(&c, "=;:[]");
+            sum = sum + str_find_last_of(&c, "=;:[]");
+            sum = sum + str_find_first_not_of(&c, " abcdefghijklmnopqrstuvw");
+            sum = sum + str_find_last_not_of(&c, " abcdefghijklmnopqrstuvw");
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        str_free(&c);
+    }
+}
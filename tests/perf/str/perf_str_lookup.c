@@ -0,0 +1,34 @@
+#include "../../test.h"
+
+#include <ctl/string.h>
+
+#define T str
+#include <ctl/set.h>
+
+#include <time.h>
+
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        str c = str_init("");
+        int elems = TEST_PERF_CHUNKS * run;
+        // words of 20 characters, looked up as views into c
+        for(int elem = 0; elem < elems; elem++)
+            str_push_back(&c, 'a'+TEST_RAND(2));
+        set_str keys = set_str_init(str_key_compare);
+        for(int elem = 0; elem + 20 <= elems; elem += 40)
+            set_str_insert(&keys, str_substr(&c, elem, 20));
+        long t0 = TEST_TIME();
+        volatile size_t found = 0;
+        for(int loop = 0; loop < 10; loop++)
+            for(int elem = 0; elem + 20 <= elems; elem += 20)
+                found = found + (set_str_find_node(&keys, strview_key(str_substr_view(&c, elem, 20))) != NULL);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        set_str_free(&keys);
+        str_free(&c);
+    }
+}
@@ -0,0 +1,37 @@
+#include "../../test.h"
+
+#include <ctl/string.h>
+
+#include <time.h>
+
+static const char *words[] = {"a", "key", "value", "unordered", "short string", "fifteen chars!!"};
+
+// create, copy and destroy many short strings, inline without a malloc
+int main(void)
+{
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        int elems = TEST_PERF_CHUNKS * run;
+        str *c = (str *)malloc((elems + 1) * sizeof(str));
+        str *d = (str *)malloc((elems + 1) * sizeof(str));
+        volatile size_t sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < elems; i++)
+            c[i] = str_init(words[i % 6]);
+        for(int i = 0; i < elems; i++)
+        {
+            d[i] = str_copy(&c[i]);
+            sum = sum + str_c_str(&d[i])[0];
+        }
+        for(int i = 0; i < elems; i++)
+        {
+            str_free(&c[i]);
+            str_free(&d[i]);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        free(c);
+        free(d);
+    }
+}
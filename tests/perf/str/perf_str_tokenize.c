@@ -0,0 +1,36 @@
+#include "../../test.h"
+
+#include <ctl/string.h>
+
+#include <time.h>
+
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    str delims = str_init(" ,;=:[]\t\n");
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        str c = str_init("");
+        int elems = TEST_PERF_CHUNKS * run;
+        // key=value fields of log lines
+        for(int elem = 0; elem < elems; elem++)
+            str_push_back(&c, TEST_RAND(16) ? 'a'+TEST_RAND(23) : str_data(&delims)[TEST_RAND(delims.size)]);
+        long t0 = TEST_TIME();
+        volatile size_t tokens = 0;
+        for(int loop = 0; loop < 10; loop++)
+        {
+            str_it range = str_it_begin(&c);
+            str_it set = str_it_begin(&delims);
+            while(str_find_first_of_range(&range, &set))
+            {
+                tokens = tokens + 1;
+                range.ref++;
+            }
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        str_free(&c);
+    }
+    str_free(&delims);
+}
@@ -0,0 +1,29 @@
+#include "../../test.h"
+
+#include <string>
+#include <time.h>
+
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::string c;
+        int elems = TEST_PERF_CHUNKS * run;
+        // words of a log line, without the separators
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(TEST_RAND(8) ? 'a'+TEST_RAND(23) : ' ');
+        long t0 = TEST_TIME();
+        volatile size_t sum = 0;
+        for(int loop = 0; loop < 25; loop++)
+        {
+            sum = sum + c.find_first_of("=;:[]");
+            sum = sum + c.find_last_of("=;:[]");
+            sum = sum + c.find_first_not_of(" abcdefghijklmnopqrstuvw");
+            sum = sum + c.find_last_not_of(" abcdefghijklmnopqrstuvw");
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -0,0 +1,38 @@
+#include "../../test.h"
+
+#include <set>
+#include <string>
+#include <time.h>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+typedef std::set<std::string, std::less<>> keyset;
+typedef std::string_view view;
+#else
+typedef std::set<std::string> keyset;
+typedef std::string view; // a copy for each lookup
+#endif
+
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::string c;
+        int elems = TEST_PERF_CHUNKS * run;
+        // words of 20 characters, looked up as views into c
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back('a'+TEST_RAND(2));
+        keyset keys;
+        for(int elem = 0; elem + 20 <= elems; elem += 40)
+            keys.insert(c.substr(elem, 20));
+        long t0 = TEST_TIME();
+        volatile size_t found = 0;
+        for(int loop = 0; loop < 10; loop++)
+            for(int elem = 0; elem + 20 <= elems; elem += 20)
+                found = found + (keys.find(view(&c[elem], 20)) != keys.end());
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
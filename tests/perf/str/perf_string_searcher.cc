@@ -0,0 +1,33 @@
+#include "../../test.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <time.h>
+
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::string c;
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back('a'+TEST_RAND(23));
+        const std::string needle = "abcdefghijklmnopqrstuvwxyz012345";
+#if __cplusplus >= 201703L
+        const std::boyer_moore_horspool_searcher<std::string::const_iterator> s(needle.begin(), needle.end());
+#endif
+        long t0 = TEST_TIME();
+        volatile size_t sum = 0;
+        for(int loop = 0; loop < 100; loop++)
+#if __cplusplus >= 201703L
+            sum = sum + (size_t)(std::search(c.cbegin(), c.cend(), s) - c.cbegin());
+#else
+            sum = sum + c.find(needle);
+#endif
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -0,0 +1,34 @@
+#include "../../test.h"
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+static const char *words[] = {"a", "key", "value", "unordered", "short string", "fifteen chars!!"};
+
+// create, copy and destroy many short strings
+int main()
+{
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        int elems = TEST_PERF_CHUNKS * run;
+        std::vector<std::string> c;
+        std::vector<std::string> d;
+        c.reserve(elems);
+        d.reserve(elems);
+        volatile size_t sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < elems; i++)
+            c.emplace_back(words[i % 6]);
+        for(int i = 0; i < elems; i++)
+        {
+            d.emplace_back(c[i]);
+            sum = sum + d[i].c_str()[0];
+        }
+        c.clear();
+        d.clear();
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -0,0 +1,32 @@
+#include "../../test.h"
+
+#include <string>
+#include <time.h>
+
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    const std::string delims = " ,;=:[]\t\n";
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::string c;
+        int elems = TEST_PERF_CHUNKS * run;
+        // key=value fields of log lines
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(TEST_RAND(16) ? 'a'+TEST_RAND(23) : delims[TEST_RAND(delims.size())]);
+        long t0 = TEST_TIME();
+        volatile size_t tokens = 0;
+        for(int loop = 0; loop < 10; loop++)
+        {
+            size_t pos = 0;
+            while((pos = c.find_first_of(delims, pos)) != std::string::npos)
+            {
+                tokens = tokens + 1;
+                pos++;
+            }
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -0,0 +1,31 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/hashmap.h>
+
+#include <time.h>
+
+static size_t int_hash(int* a) { return *a; }
+static int int_equal(int* a, int* b)   { return *a == *b; }
+
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    hmap_int c = hmap_int_init(int_hash, int_equal);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        unsigned int elems = TEST_PERF_CHUNKS * run;
+        hmap_int_reserve(&c, elems);
+        for(unsigned int elem = 0; elem < elems; elem++)
+            hmap_int_insert(&c, rand() % elems);
+        volatile int sum = 0;
+        long t0 = TEST_TIME();
+        foreach(hmap_int, &c, it)
+            sum = sum + *it.ref;
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+    hmap_int_free(&c);
+}
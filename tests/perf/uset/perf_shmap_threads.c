@@ -0,0 +1,139 @@
+// Scaling of the sharded map from 1 to all cores, against one umap behind a
+// single mutex. A fixed number of operations is split over the threads:
+// 50% insert_or_assign, 40% find, 10% erase on random keys.
+#include "../../test.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct
+{
+    int key;
+    int value;
+} intint;
+
+static size_t intint_hash(intint *a) { return ctl_hash_int((uint64_t)a->key); }
+static int intint_equal(intint *a, intint *b) { return a->key == b->key; }
+
+#define POD
+#define NOT_INTEGRAL
+#define T intint
+#include <ctl/sharded_map.h>
+
+#define OPS (1 << 22)
+#define KEYS (1 << 18)
+
+static shmap_intint sharded;
+static umap_intint locked;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct
+{
+    uint64_t rng;
+    long ops;
+    int found;
+} job;
+
+static inline int next_rand(job *j)
+{
+    // xorshift64, rand() is not thread-safe
+    j->rng ^= j->rng << 13;
+    j->rng ^= j->rng >> 7;
+    j->rng ^= j->rng << 17;
+    return (int)(j->rng >> 33);
+}
+
+static void *run_sharded(void *arg)
+{
+    job *j = (job *)arg;
+    for (long i = 0; i < j->ops; i++)
+    {
+        const int r = next_rand(j);
+        intint v = {r % KEYS, r};
+        const int op = r % 10;
+        if (op < 5)
+            shmap_intint_insert_or_assign(&sharded, v);
+        else if (op < 9)
+        {
+            intint found;
+            j->found += shmap_intint_find(&sharded, v, &found);
+        }
+        else
+            shmap_intint_erase(&sharded, v);
+    }
+    return NULL;
+}
+
+static void *run_locked(void *arg)
+{
+    job *j = (job *)arg;
+    for (long i = 0; i < j->ops; i++)
+    {
+        const int r = next_rand(j);
+        intint v = {r % KEYS, r};
+        const int op = r % 10;
+        pthread_mutex_lock(&lock);
+        if (op < 5)
+        {
+            int found;
+            umap_intint_it it = umap_intint_insert_or_assign_found(&locked, v, &found);
+            if (found)
+                *it.ref = v;
+        }
+        else if (op < 9)
+            j->found += umap_intint_find_node(&locked, v) != NULL;
+        else
+            umap_intint_erase(&locked, v);
+        pthread_mutex_unlock(&lock);
+    }
+    return NULL;
+}
+
+static long bench(void *(*fn)(void *), int threads)
+{
+    pthread_t tids[256];
+    job jobs[256];
+    long t0 = TEST_TIME();
+    for (int t = 0; t < threads; t++)
+    {
+        jobs[t].rng = 0x9e3779b97f4a7c15ULL * (t + 1);
+        jobs[t].ops = OPS / threads;
+        jobs[t].found = 0;
+        pthread_create(&tids[t], NULL, fn, &jobs[t]);
+    }
+    for (int t = 0; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    return TEST_TIME() - t0;
+}
+
+int main(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1)
+        cores = 1;
+    if (cores > 256)
+        cores = 256;
+    puts(__FILE__);
+    printf("%7s %10s %10s %10s %10s\n", "threads", "sharded", "speedup", "locked", "speedup");
+    long sharded1 = 0, locked1 = 0;
+    for (int threads = 1;; threads *= 2)
+    {
+        if (threads > cores)
+            threads = (int)cores;
+        sharded = shmap_intint_init(intint_hash, intint_equal);
+        locked = umap_intint_init(intint_hash, intint_equal);
+        const long tl = bench(run_locked, threads);
+        const long ts = bench(run_sharded, threads);
+        if (threads == 1)
+        {
+            sharded1 = ts;
+            locked1 = tl;
+        }
+        printf("%7d %10ld %10.2f %10ld %10.2f\n", threads, ts, (double)sharded1 / ts, tl,
+               (double)locked1 / tl);
+        shmap_intint_free(&sharded);
+        umap_intint_free(&locked);
+        if (threads == cores)
+            break;
+    }
+}
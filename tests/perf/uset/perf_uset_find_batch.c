@@ -0,0 +1,55 @@
+// contains_batch vs. the scalar contains loop, on the same keys.
+// Half of the keys are missing. The sets outgrow the caches, where the
+// prefetching of the batch pays off.
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#include <time.h>
+
+#define SCALE 16
+
+static size_t int_hash(int* a) { return *a; }
+static int int_equal(int* a, int* b)   { return *a == *b; }
+
+int main(void)
+{
+    static long batch[TEST_PERF_RUNS];
+    static long scalar[TEST_PERF_RUNS];
+    const int max = SCALE * TEST_PERF_CHUNKS * TEST_PERF_RUNS;
+    int *keys = (int *)malloc(max * sizeof(int));
+    bool *found = (bool *)malloc(max * sizeof(bool));
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        uset_int c = uset_int_init(int_hash, int_equal);
+        int elems = SCALE * TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            uset_int_insert(&c, rand() % elems);
+        for(int elem = 0; elem < elems; elem++)
+            keys[elem] = rand() % (2 * elems);
+        volatile int sum = 0;
+        long t0 = TEST_TIME();
+        uset_int_contains_batch(&c, keys, elems, found);
+        long t1 = TEST_TIME();
+        for(int elem = 0; elem < elems; elem++)
+            sum = sum + found[elem];
+        long t2 = TEST_TIME();
+        for(int elem = 0; elem < elems; elem++)
+            sum = sum + uset_int_contains(&c, keys[elem]);
+        long t3 = TEST_TIME();
+        batch[run] = t1 - t0;
+        scalar[run] = t3 - t2;
+        uset_int_free(&c);
+    }
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+        printf("%10d %10ld\n", SCALE * TEST_PERF_CHUNKS * run, batch[run]);
+    puts("uset_int_contains.scalar");
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+        printf("%10d %10ld\n", SCALE * TEST_PERF_CHUNKS * run, scalar[run]);
+    free(keys);
+    free(found);
+}
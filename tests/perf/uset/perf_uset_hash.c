@@ -0,0 +1,139 @@
+// Hash quality and throughput of the default hashes against the identity
+// integer hash and FNV1a. Built with both growth policies, as
+// perf_uset_hash and perf_uset_hash_power2.
+#include "../../test.h"
+
+// no sleeping on the long chains of the identity hash
+#define CTL_USET_SECURITY_COLLCOUNTING 0
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#include <string.h>
+
+#define ELEMS (1 << 18)
+#define STRS (1 << 16)
+
+static size_t identity_hash(int* a) { return (size_t)*a; }
+
+static size_t fnv1a(const char *s)
+{
+    size_t h = 2166136261u;
+    for (; *s; s++)
+    {
+        h ^= (unsigned char)*s;
+        h *= 16777619;
+    }
+    return h;
+}
+
+// the old default, with strlen in the loop condition
+static size_t fnv1a_strlen(const char *s)
+{
+    size_t h = 2166136261u;
+    for (unsigned i = 0; i < strlen(s); i++)
+    {
+        h ^= (unsigned char)s[i];
+        h *= 16777619;
+    }
+    return h;
+}
+
+static int key(int pattern, int i)
+{
+    switch (pattern)
+    {
+    case 0:
+        return i;
+    case 1:
+        return i << 10; // all low bits clear
+    default:
+        return rand();
+    }
+}
+
+// the expected number of equal calls for a successful find. 1.5 with
+// load factor 1 and a perfect hash.
+static double probes(uset_int *c)
+{
+    size_t sum = 0;
+    for (size_t i = 0; i < uset_int_bucket_count(c); i++)
+    {
+        size_t len = uset_int_bucket_size(c, i);
+        sum += len * (len + 1) / 2;
+    }
+    return c->size ? (double)sum / c->size : 0.0;
+}
+
+static size_t max_chain(uset_int *c)
+{
+    size_t max = 0;
+    for (size_t i = 0; i < uset_int_bucket_count(c); i++)
+    {
+        size_t len = uset_int_bucket_size(c, i);
+        if (len > max)
+            max = len;
+    }
+    return max;
+}
+
+static void bench_int(const char *name, size_t (*hash)(int *))
+{
+    static const char *patterns[] = {"sequential", "stride 1024", "random"};
+    for (int p = 0; p < 3; p++)
+    {
+        uset_int c = uset_int_init(hash, NULL);
+        volatile int sum = 0;
+        srand(0xbeef);
+        long t0 = TEST_TIME();
+        for (int i = 0; i < ELEMS; i++)
+            uset_int_insert(&c, key(p, i));
+        srand(0xbeef);
+        for (int i = 0; i < ELEMS; i++)
+            sum = sum + uset_int_contains(&c, key(p, i));
+        long t1 = TEST_TIME();
+        printf("%-8s %-12s %10ld %10.2f %10zu\n", name, patterns[p], t1 - t0, probes(&c), max_chain(&c));
+        uset_int_free(&c);
+    }
+}
+
+static void bench_str(const char *name, size_t (*hash)(const char *), char **strs, size_t len)
+{
+    volatile size_t sum = 0;
+    long t0 = TEST_TIME();
+    for (int i = 0; i < STRS; i++)
+        sum = sum + hash(strs[i]);
+    long t1 = TEST_TIME();
+    printf("%-14s %4zu %10.2f\n", name, len, 1000.0 * (t1 - t0) / STRS);
+}
+
+int main(void)
+{
+    static const size_t lens[] = {8, 24, 100};
+    char **strs = (char **)malloc(STRS * sizeof(char *));
+    puts(__FILE__);
+#ifdef CTL_USET_GROWTH_POWER2
+    puts("CTL_USET_GROWTH_POWER2");
+#endif
+    printf("%-8s %-12s %10s %10s %10s\n", "hash", "keys", "us", "probes", "max chain");
+    bench_int("identity", identity_hash);
+    bench_int("default", NULL);
+
+    printf("\n%-14s %4s %10s\n", "hash", "len", "ns/string");
+    for (int l = 0; l < 3; l++)
+    {
+        for (int i = 0; i < STRS; i++)
+        {
+            strs[i] = (char *)malloc(lens[l] + 1);
+            for (size_t j = 0; j < lens[l]; j++)
+                strs[i][j] = 'a' + rand() % 26;
+            strs[i][lens[l]] = '\0';
+        }
+        bench_str("fnv1a strlen", fnv1a_strlen, strs, lens[l]);
+        bench_str("fnv1a", fnv1a, strs, lens[l]);
+        bench_str("ctl_hash_str", ctl_hash_str, strs, lens[l]);
+        for (int i = 0; i < STRS; i++)
+            free(strs[i]);
+    }
+    free(strs);
+}
@@ -0,0 +1,79 @@
+// Histogram of the single insert latencies, to compare the growth stalls
+// with and without -DCTL_USET_INCREMENTAL_REHASH.
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#include <time.h>
+
+#define ELEMS (1 << 21)
+#define SLOTS 32
+
+static size_t int_hash(int* a) { return *a; }
+static int int_equal(int* a, int* b)   { return *a == *b; }
+
+static inline long now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return 1000000000L * ts.tv_sec + ts.tv_nsec;
+}
+
+// log2 slots of nanoseconds
+static inline int slot(long ns)
+{
+    int i = 0;
+    while (ns > 1 && i < SLOTS - 1)
+    {
+        ns >>= 1;
+        i++;
+    }
+    return i;
+}
+
+static long percentile(size_t *hist, double p)
+{
+    size_t want = (size_t)(p * ELEMS);
+    size_t sum = 0;
+    for (int i = 0; i < SLOTS; i++)
+    {
+        sum += hist[i];
+        if (sum >= want)
+            return 2L << i;
+    }
+    return 2L << (SLOTS - 1);
+}
+
+int main(void)
+{
+    static size_t hist[SLOTS];
+    long max = 0;
+    puts(__FILE__);
+#ifdef CTL_USET_INCREMENTAL_REHASH
+    puts("CTL_USET_INCREMENTAL_REHASH");
+#endif
+    srand(0xbeef);
+    uset_int c = uset_int_init(int_hash, int_equal);
+    long t0 = TEST_TIME();
+    for(int elem = 0; elem < ELEMS; elem++)
+    {
+        int value = rand();
+        long t = now_ns();
+        uset_int_insert(&c, value);
+        t = now_ns() - t;
+        hist[slot(t)]++;
+        if (t > max)
+            max = t;
+    }
+    long t1 = TEST_TIME();
+    uset_int_free(&c);
+
+    printf("%10s %10s\n", "<= ns", "inserts");
+    for (int i = 0; i < SLOTS; i++)
+        if (hist[i])
+            printf("%10ld %10zu\n", 2L << i, hist[i]);
+    printf("p50 <= %ldns, p99 <= %ldns, p99.9 <= %ldns, max %ldns, total %ldus\n",
+           percentile(hist, 0.5), percentile(hist, 0.99), percentile(hist, 0.999), max, t1 - t0);
+}
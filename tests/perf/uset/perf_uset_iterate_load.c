@@ -0,0 +1,47 @@
+// Iteration and clear over a table thinned out by erases, at several load
+// factors. Built with and without the bucket bitmap, as perf_uset_iterate_load
+// and perf_uset_iterate_load_bitmap.
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/unordered_set.h>
+
+#define ELEMS (1 << 20)
+#define LOOPS 16
+
+static size_t int_hash(int* a) { return (size_t)*a; }
+static int int_equal(int* a, int* b) { return *a == *b; }
+
+int main(void)
+{
+    static const int divs[] = {1, 2, 4, 16, 64, 256};
+    puts(__FILE__);
+#ifdef CTL_USET_BUCKET_BITMAP
+    puts("CTL_USET_BUCKET_BITMAP");
+#endif
+    printf("%10s %10s %10s %10s\n", "load", "size", "iterate", "clear");
+    for (unsigned d = 0; d < sizeof(divs) / sizeof(*divs); d++)
+    {
+        uset_int c = uset_int_init(int_hash, int_equal);
+        uset_int_reserve(&c, ELEMS);
+        for (int i = 0; i < ELEMS; i++)
+            uset_int_insert(&c, i);
+        // keep every divs[d]th key, the buckets are not shrunk
+        for (int i = 0; i < ELEMS; i++)
+            if (i % divs[d])
+                uset_int_erase(&c, i);
+        volatile unsigned sum = 0;
+        long t0 = TEST_TIME();
+        for (int loop = 0; loop < LOOPS; loop++)
+            foreach(uset_int, &c, it)
+                sum = sum + (unsigned)*it.ref;
+        long t1 = TEST_TIME();
+        const float load = uset_int_load_factor(&c);
+        const size_t size = c.size;
+        uset_int_clear(&c);
+        long t2 = TEST_TIME();
+        printf("%10.4f %10zu %10ld %10ld\n", load, size, (t1 - t0) / LOOPS, t2 - t1);
+        uset_int_free(&c);
+    }
+}
@@ -0,0 +1,38 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#define N 8
+#include <ctl/small_vector.h>
+
+#include <time.h>
+
+// many vectors with up to 8 elements, inline without a malloc
+int main(void)
+{
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        int elems = TEST_PERF_CHUNKS * run;
+        svec8_int *c = (svec8_int *)malloc((elems + 1) * sizeof(svec8_int));
+        volatile long sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < elems; i++)
+        {
+            c[i] = svec8_int_init();
+            for(int j = i % 8; j >= 0; j--)
+                svec8_int_push_back(&c[i], j);
+        }
+        for(int i = 0; i < elems; i++)
+        {
+            int *ref = svec8_int_data(&c[i]);
+            for(size_t j = 0; j < c[i].size; j++)
+                sum = sum + ref[j];
+        }
+        for(int i = 0; i < elems; i++)
+            svec8_int_free(&c[i]);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        free(c);
+    }
+}
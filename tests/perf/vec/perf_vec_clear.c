@@ -0,0 +1,29 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#include <time.h>
+
+// 64 clears of a refilled vector, only the clears are timed
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        vec_int c = vec_int_init();
+        int elems = TEST_PERF_CHUNKS * run;
+        long sum = 0;
+        for(int i = 0; i < 64; i++)
+        {
+            vec_int_resize(&c, elems, rand());
+            long t0 = TEST_TIME();
+            vec_int_clear(&c);
+            sum += TEST_TIME() - t0;
+        }
+        printf("%10d %10ld\n", elems, sum);
+        vec_int_free(&c);
+    }
+}
@@ -0,0 +1,34 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#include <time.h>
+
+// 8 erases of a range with 1/16 of the elements, at random positions
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        vec_int c = vec_int_init();
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            vec_int_push_back(&c, rand());
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 8; i++)
+        {
+            const size_t count = elems / 16;
+            const size_t from = rand() % (c.size - count + 1);
+            vec_int_it range = vec_int_begin(&c);
+            vec_int_it_advance(&range, from);
+            range.end = range.ref + count;
+            vec_int_erase_range(&range);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        vec_int_free(&c);
+    }
+}
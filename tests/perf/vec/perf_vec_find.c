@@ -0,0 +1,32 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#define INCLUDE_ALGORITHM
+#include <ctl/vector.h>
+
+#include <time.h>
+
+// 64 unsuccessful finds and counts, SIMD unless CTL_NO_SIMD
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        vec_int c = vec_int_init();
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            vec_int_push_back(&c, rand() & 0xffff);
+        volatile size_t sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 64; i++)
+        {
+            vec_int_it it = vec_int_find(&c, -1 - i);
+            sum = sum + vec_int_it_index(&it) + vec_int_count(&c, -1 - i);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        vec_int_free(&c);
+    }
+}
@@ -0,0 +1,29 @@
+// push_back of up to 32M ints into fresh vectors: the time, the unused
+// capacity, and the peak RSS. Built also with CTL_VEC_GROWTH_FACTOR=1.5 and
+// with CTL_VEC_MMAP, see the GNUmakefile.
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#include <sys/resource.h>
+
+int main(void)
+{
+    puts(__FILE__);
+    printf("%10s %10s %10s\n", "elems", "usec", "slack MB");
+    for (int elems = 1000000; elems <= 32000000; elems *= 2)
+    {
+        vec_int c = vec_int_init();
+        long t0 = TEST_TIME();
+        for (int elem = 0; elem < elems; elem++)
+            vec_int_push_back(&c, elem);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld %10.1f\n", elems, t1 - t0, (double)(c.capacity - c.size) * sizeof(int) / (1 << 20));
+        vec_int_free(&c);
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("peak RSS %ld MB\n", usage.ru_maxrss / 1024);
+}
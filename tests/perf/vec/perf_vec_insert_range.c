@@ -0,0 +1,36 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#include <time.h>
+
+// 8 inserts of a range with 1/8 of the elements, at random positions
+int main(void)
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        vec_int c = vec_int_init();
+        vec_int d = vec_int_init();
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            vec_int_push_back(&c, rand());
+        for(int elem = 0; elem < elems / 8 + 1; elem++)
+            vec_int_push_back(&d, rand());
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 8; i++)
+        {
+            vec_int_it pos = vec_int_begin(&c);
+            vec_int_it_advance(&pos, rand() % (c.size + 1));
+            vec_int_it range = vec_int_begin(&d);
+            vec_int_insert_range(&pos, &range);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        vec_int_free(&c);
+        vec_int_free(&d);
+    }
+}
@@ -1,3 +1,6 @@
+// Sorts random ints, as graphed by gen_images.sh. With an element count
+// argument (0 for 2^20) the sorted, reversed, all-equal and few-unique inputs
+// are timed also, with sort (a radix sort for ints) and the quicksort.
 #include "../../test.h"
 
 #define POD
@@ -6,10 +9,52 @@
 
 #include <time.h>
 
-int main(void)
+#define SHAPE_ELEMS (1 << 20)
+
+static const char *shapes[] = {"random", "sorted", "reversed", "equal", "few_unique"};
+
+static int generate(int shape, int elem, int elems)
+{
+    switch (shape)
+    {
+    case 1:
+        return elem;
+    case 2:
+        return elems - elem;
+    case 3:
+        return 42;
+    case 4:
+        return rand() % 16;
+    default:
+        return rand();
+    }
+}
+
+int main(int argc, char **argv)
 {
     puts(__FILE__);
     srand(0xbeef);
+    if (argc > 1)
+    {
+        const int elems = atoi(argv[1]) > 0 ? atoi(argv[1]) : SHAPE_ELEMS;
+        printf("%10s %10s %10s %10s\n", "input", "elems", "sort", "quicksort");
+        for (int shape = 0; shape < (int)len(shapes); shape++)
+        {
+            vec_int c = vec_int_init();
+            for (int elem = 0; elem < elems; elem++)
+                vec_int_push_back(&c, generate(shape, elem, elems));
+            vec_int q = vec_int_copy(&c);
+            long t0 = TEST_TIME();
+            vec_int_sort(&c);
+            long t1 = TEST_TIME();
+            vec_int__ranged_sort(&q, 0, elems - 1, q.compare);
+            long t2 = TEST_TIME();
+            printf("%10s %10d %10ld %10ld\n", shapes[shape], elems, t1 - t0, t2 - t1);
+            vec_int_free(&c);
+            vec_int_free(&q);
+        }
+        return 0;
+    }
     for(int run = 0; run < TEST_PERF_RUNS; run++)
     {
         vec_int c = vec_int_init();
@@ -0,0 +1,64 @@
+// Scaling of vec_int_sort_parallel from 1 to all cores, on random ints with
+// the default compare, i.e. radix sorted buckets, and with a compare method,
+// i.e. pdqsorted buckets. The 1 thread column is the serial sort.
+#define CTL_SORT_PARALLEL
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#define SIZE (1 << 24)
+
+static int int_less(int *a, int *b)
+{
+    return *a < *b;
+}
+
+static long bench(vec_int *v, int *input, int (*compare)(int *, int *), size_t threads)
+{
+    memcpy(v->vector, input, SIZE * sizeof(int));
+    v->compare = compare;
+    long t0 = TEST_TIME();
+    if (threads == 1)
+        vec_int_sort(v);
+    else
+        vec_int_sort_parallel(v, threads);
+    return TEST_TIME() - t0;
+}
+
+int main(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1)
+        cores = 1;
+    if (cores > CTL_SORT_THREADS_MAX)
+        cores = CTL_SORT_THREADS_MAX;
+    int *input = (int *)malloc(SIZE * sizeof(int));
+    for (int i = 0; i < SIZE; i++)
+        input[i] = rand();
+    vec_int v = vec_int_init();
+    vec_int_resize(&v, SIZE, 0);
+    int (*integral)(int *, int *) = v.compare;
+    puts(__FILE__);
+    printf("%7s %10s %10s %10s %10s\n", "threads", "default", "speedup", "compare", "speedup");
+    long default1 = 0, compare1 = 0;
+    for (long threads = 1;; threads *= 2)
+    {
+        if (threads > cores)
+            threads = cores;
+        const long td = bench(&v, input, integral, (size_t)threads);
+        const long tc = bench(&v, input, int_less, (size_t)threads);
+        if (threads == 1)
+        {
+            default1 = td;
+            compare1 = tc;
+        }
+        printf("%7ld %10ld %10.2f %10ld %10.2f\n", threads, td, (double)default1 / td, tc,
+               (double)compare1 / tc);
+        if (threads == cores)
+            break;
+    }
+    vec_int_free(&v);
+    free(input);
+}
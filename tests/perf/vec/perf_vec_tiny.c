@@ -0,0 +1,34 @@
+#include "../../test.h"
+
+#define POD
+#define T int
+#include <ctl/vector.h>
+
+#include <time.h>
+
+// many vectors with up to 8 elements
+int main(void)
+{
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        int elems = TEST_PERF_CHUNKS * run;
+        vec_int *c = (vec_int *)malloc((elems + 1) * sizeof(vec_int));
+        volatile long sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < elems; i++)
+        {
+            c[i] = vec_int_init();
+            for(int j = i % 8; j >= 0; j--)
+                vec_int_push_back(&c[i], j);
+        }
+        for(int i = 0; i < elems; i++)
+            vec_foreach(int, &c[i], ref)
+                sum = sum + *ref;
+        for(int i = 0; i < elems; i++)
+            vec_int_free(&c[i]);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+        free(c);
+    }
+}
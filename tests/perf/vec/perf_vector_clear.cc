@@ -0,0 +1,25 @@
+#include "../../test.h"
+
+#include <vector>
+#include <time.h>
+
+// 64 clears of a refilled vector, only the clears are timed
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::vector<int> c;
+        int elems = TEST_PERF_CHUNKS * run;
+        long sum = 0;
+        for(int i = 0; i < 64; i++)
+        {
+            c.resize(elems, rand());
+            long t0 = TEST_TIME();
+            c.clear();
+            sum += TEST_TIME() - t0;
+        }
+        printf("%10d %10ld\n", elems, sum);
+    }
+}
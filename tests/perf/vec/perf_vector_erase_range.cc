@@ -0,0 +1,27 @@
+#include "../../test.h"
+
+#include <vector>
+#include <time.h>
+
+// 8 erases of a range with 1/16 of the elements, at random positions
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::vector<int> c;
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(rand());
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 8; i++)
+        {
+            const size_t count = elems / 16;
+            const size_t from = rand() % (c.size() - count + 1);
+            c.erase(c.begin() + from, c.begin() + from + count);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -0,0 +1,28 @@
+#include "../../test.h"
+
+#include <algorithm>
+#include <vector>
+#include <time.h>
+
+// 64 unsuccessful finds and counts
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::vector<int> c;
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(rand() & 0xffff);
+        volatile size_t sum = 0;
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 64; i++)
+        {
+            auto it = std::find(c.begin(), c.end(), -1 - i);
+            sum = sum + (it - c.begin()) + std::count(c.begin(), c.end(), -1 - i);
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
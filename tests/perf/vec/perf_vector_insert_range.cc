@@ -0,0 +1,26 @@
+#include "../../test.h"
+
+#include <vector>
+#include <time.h>
+
+// 8 inserts of a range with 1/8 of the elements, at random positions
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::vector<int> c;
+        std::vector<int> d;
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(rand());
+        for(int elem = 0; elem < elems / 8 + 1; elem++)
+            d.push_back(rand());
+        long t0 = TEST_TIME();
+        for(int i = 0; i < 8; i++)
+            c.insert(c.begin() + rand() % (c.size() + 1), d.begin(), d.end());
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
@@ -1,15 +1,55 @@
+// Sorts random ints, as graphed by gen_images.sh. With an element count
+// argument (0 for 2^20) the sorted, reversed, all-equal and few-unique inputs
+// are timed also.
 #include "../../test.h"
 
 #include <algorithm>
 #include <vector>
 #include <time.h>
 
+#define SHAPE_ELEMS (1 << 20)
+
+static const char *shapes[] = {"random", "sorted", "reversed", "equal", "few_unique"};
+
 static bool compare(int& a, int& b) { return a < b; }
 
-int main()
+static int generate(int shape, int elem, int elems)
+{
+    switch (shape)
+    {
+    case 1:
+        return elem;
+    case 2:
+        return elems - elem;
+    case 3:
+        return 42;
+    case 4:
+        return rand() % 16;
+    default:
+        return rand();
+    }
+}
+
+int main(int argc, char **argv)
 {
     puts(__FILE__);
     srand(0xbeef);
+    if (argc > 1)
+    {
+        const int elems = atoi(argv[1]) > 0 ? atoi(argv[1]) : SHAPE_ELEMS;
+        printf("%10s %10s %10s\n", "input", "elems", "std::sort");
+        for (int shape = 0; shape < (int)(sizeof(shapes) / sizeof(*shapes)); shape++)
+        {
+            std::vector<int> c;
+            for (int elem = 0; elem < elems; elem++)
+                c.push_back(generate(shape, elem, elems));
+            long t0 = TEST_TIME();
+            std::sort(c.begin(), c.end(), compare);
+            long t1 = TEST_TIME();
+            printf("%10s %10d %10ld\n", shapes[shape], elems, t1 - t0);
+        }
+        return 0;
+    }
     for(int run = 0; run < TEST_PERF_RUNS; run++)
     {
         std::vector<int> c;
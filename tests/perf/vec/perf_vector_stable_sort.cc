@@ -0,0 +1,26 @@
+// Stable sort of partially sorted ints: ascending, with every 16th random.
+#include "../../test.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <time.h>
+
+static bool compare(const int& a, const int& b) { return a < b; }
+
+int main()
+{
+    puts(__FILE__);
+    srand(0xbeef);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        std::vector<int> c;
+        int elems = TEST_PERF_CHUNKS * run;
+        for(int elem = 0; elem < elems; elem++)
+            c.push_back(elem % 16 ? elem : rand() % (elems + 1));
+        long t0 = TEST_TIME();
+        std::stable_sort(c.begin(), c.end(), compare);
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}
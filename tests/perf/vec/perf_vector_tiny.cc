@@ -0,0 +1,27 @@
+#include "../../test.h"
+
+#include <vector>
+#include <time.h>
+
+// many vectors with up to 8 elements
+int main()
+{
+    puts(__FILE__);
+    for(int run = 0; run < TEST_PERF_RUNS; run++)
+    {
+        int elems = TEST_PERF_CHUNKS * run;
+        volatile long sum = 0;
+        long t0 = TEST_TIME();
+        {
+            std::vector<std::vector<int>> c(elems);
+            for(int i = 0; i < elems; i++)
+                for(int j = i % 8; j >= 0; j--)
+                    c[i].push_back(j);
+            for(int i = 0; i < elems; i++)
+                for(auto &ref : c[i])
+                    sum = sum + ref;
+        }
+        long t1 = TEST_TIME();
+        printf("%10d %10ld\n", elems, t1 - t0);
+    }
+}